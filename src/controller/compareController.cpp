@@ -34,7 +34,7 @@ void CompareController::setMetadata(std::shared_ptr<FrameMeta> meta1,
         m_metadata1->yHeight() == m_metadata2->yHeight()) {
 
         if (m_diffWindow) {
-            m_diffWindow->initialize(m_metadata1, queue1, queue2);
+            m_diffWindow->initialize(m_metadata1, m_metadata2, queue1, queue2);
             connect(
                 this, &CompareController::requestUpload, m_diffWindow, &DiffWindow::uploadFrame, Qt::DirectConnection);
             connect(
@@ -53,12 +53,14 @@ void CompareController::setMetadata(std::shared_ptr<FrameMeta> meta1,
 // When either FC requested to upload a frame
 void CompareController::onReceiveFrame(FrameData* frame, int index) {
 
-    // Make a copy of the frame data
+    // The sender pins the frame while it is handed over, its pts is stable until we return
     if (index == m_index1 && frame) {
-        m_frame1 = std::make_unique<FrameData>(*frame);
+        m_frame1 = frame;
+        m_pts1 = frame->pts();
         debug("cc", QString("Received frame from index: %1").arg(index));
     } else if (index == m_index2 && frame) {
-        m_frame2 = std::make_unique<FrameData>(*frame);
+        m_frame2 = frame;
+        m_pts2 = frame->pts();
         debug("cc", QString("Received frame from index: %1").arg(index));
     } else {
         warning("cc", "Received frame for unknown index:" + QString::number(index));
@@ -78,20 +80,27 @@ void CompareController::onReceiveFrame(FrameData* frame, int index) {
     }
 
     if (m_frame1 && m_frame2) {
-        AVRational time1 = av_mul_q(AVRational{static_cast<int>(m_frame1->pts()), 1}, m_metadata1->timeBase());
-        AVRational time2 = av_mul_q(AVRational{static_cast<int>(m_frame2->pts()), 1}, m_metadata2->timeBase());
+        AVRational time1 = av_mul_q(AVRational{static_cast<int>(m_pts1), 1}, m_metadata1->timeBase());
+        AVRational time2 = av_mul_q(AVRational{static_cast<int>(m_pts2), 1}, m_metadata2->timeBase());
 
-        debug("cc", QString("Comparing frames at time1: %1, time2: %2").arg(m_frame1->pts()).arg(m_frame2->pts()));
+        debug("cc", QString("Comparing frames at time1: %1, time2: %2").arg(m_pts1).arg(m_pts2));
 
         if (av_cmp_q(time1, time2) == 0) {
-            debug("cc", QString("Received same time frames, diffing at pts: %1").arg(m_frame1->pts()));
-            m_psnrResult =
-                m_compareHelper->getPSNR(m_frame1.get(), m_frame2.get(), m_metadata1.get(), m_metadata2.get());
+            // The frame received first may have been evicted while waiting for the other one
+            FramePin pin1(m_frame1, m_pts1);
+            FramePin pin2(m_frame2, m_pts2);
+            if (!pin1 || !pin2) {
+                warning("cc", QString("Frames at pts %1 were replaced before diffing").arg(m_pts1));
+                return;
+            }
+
+            debug("cc", QString("Received same time frames, diffing at pts: %1").arg(m_pts1));
+            m_psnrResult = m_compareHelper->getPSNR(m_frame1, m_frame2, m_metadata1.get(), m_metadata2.get());
             m_psnr = m_psnrResult.average;
 
             m_diffed = true;
 
-            emit requestUpload(m_frame1.get(), m_frame2.get());
+            emit requestUpload(m_frame1, m_frame2);
         } else {
             debug("cc", "Received different time frames, skipping");
         }
@@ -131,10 +140,10 @@ void CompareController::onCompareRendered() {
 
     // Clear cache to make sure we don't compare stale frames
     if (m_frame1 && m_diffed) {
-        m_frame1.reset();
+        m_frame1 = nullptr;
     }
     if (m_frame2 && m_diffed) {
-        m_frame2.reset();
+        m_frame2 = nullptr;
     }
 
     if (!m_frame1 && !m_frame2) {
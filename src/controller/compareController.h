@@ -41,8 +41,11 @@ class CompareController : public QObject {
     int m_index1 = -1;
     int m_index2 = -1;
 
-    std::unique_ptr<FrameData> m_frame1 = nullptr;
-    std::unique_ptr<FrameData> m_frame2 = nullptr;
+    // Queue slots of the frames to compare, pinned with their pts whenever their pixels are read
+    FrameData* m_frame1 = nullptr;
+    FrameData* m_frame2 = nullptr;
+    int64_t m_pts1 = -1;
+    int64_t m_pts2 = -1;
 
     std::shared_ptr<FrameMeta> m_metadata1 = nullptr;
     std::shared_ptr<FrameMeta> m_metadata2 = nullptr;
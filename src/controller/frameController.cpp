@@ -1,5 +1,8 @@
 #include "frameController.h"
 #include <QThread>
+#include <algorithm>
+#include <cstdlib>
+#include "frames/frameArena.h"
 #include "utils/appConfig.h"
 #include "utils/debugManager.h"
 
@@ -8,38 +11,107 @@ FrameController::FrameController(QObject* parent, VideoFileInfo videoFileInfo, i
     m_index(index) {
     debug("fc", QString("Constructor invoked for index %1").arg(m_index));
 
-    m_Decoder = std::make_unique<VideoDecoder>();
-    m_Decoder->setFileName(videoFileInfo.filename.toStdString());
-    m_Decoder->setDimensions(videoFileInfo.width, videoFileInfo.height);
-    m_Decoder->setFramerate(videoFileInfo.framerate);
-    m_Decoder->setFormat(videoFileInfo.pixelFormat);
-    m_Decoder->setForceSoftwareDecoding(videoFileInfo.forceSoftwareDecoding);
-    m_Decoder->openFile();
-
-    m_frameMeta = std::make_shared<FrameMeta>(m_Decoder->getMetaData());
-    m_frameQueue = std::make_shared<FrameQueue>(m_frameMeta, AppConfig::instance().getQueueSize());
-
-    m_Decoder->setFrameQueue(m_frameQueue);
+    // A pipe can only be read once, a single decoder serves a live stream
+    bool stream = StreamFrameReader::isStreamPath(videoFileInfo.filename);
+    int decoderCount = stream ? 1 : std::max(AppConfig::instance().getDecoderCount(), 1);
+    for (int i = 0; i < decoderCount; ++i) {
+        auto decoder = std::make_unique<VideoDecoder>();
+        decoder->setFileName(videoFileInfo.filename.toStdString());
+        decoder->setDimensions(videoFileInfo.width, videoFileInfo.height);
+        decoder->setFramerate(videoFileInfo.framerate);
+        decoder->setFormat(videoFileInfo.pixelFormat);
+        decoder->setForceSoftwareDecoding(videoFileInfo.forceSoftwareDecoding);
+        decoder->setDecodeThreads(AppConfig::instance().getDecodeThreads());
+        decoder->setGpuUnpack(AppConfig::instance().getGpuUnpack());
+        decoder->setStreamHistory(AppConfig::instance().getStreamHistory());
+        // Only the first decoder probes and indexes the file
+        if (i > 0) {
+            decoder->shareProbe(m_segments.front().decoder.get());
+        }
+        decoder->openFile();
+        m_segments.push_back({std::move(decoder), std::make_unique<QThread>()});
+    }
+    VideoDecoder* primary = m_segments.front().decoder.get();
+    m_intraOnly = primary->isIntraOnly();
+    m_live = primary->isLive();
+
+    m_frameMeta = std::make_shared<FrameMeta>(primary->getMetaData());
+    int queueSize = AppConfig::instance().getQueueSize();
+    int64_t cacheBudget = AppConfig::instance().getCacheBudget();
+    if (cacheBudget > 0) {
+        // Videos already loaded give back frames they can spare when the new queue needs the room
+        int64_t share = FrameArena::instance().fairShare();
+        queueSize = FrameQueue::slotsForBudget(*m_frameMeta, share);
+        debug("fc",
+              QString("Cache share of %1 MB gives index %2 a queue of %3 frames")
+                  .arg(share >> 20)
+                  .arg(m_index)
+                  .arg(queueSize));
+    }
+    m_frameQueue = std::make_shared<FrameQueue>(m_frameMeta, queueSize);
 
     m_window = videoFileInfo.windowPtr;
     debug("fc", QString("Created and showed VideoWindow for index %1").arg(m_index));
 
     m_window->initialize(m_frameMeta);
 
-    // Initialize decoder thread
+    // Initialize decoder threads
+    for (size_t i = 0; i < m_segments.size(); ++i) {
+        VideoDecoder* decoder = m_segments[i].decoder.get();
+        QThread* thread = m_segments[i].thread.get();
+        decoder->setFrameQueue(m_frameQueue);
+        decoder->moveToThread(thread);
+        debug("fc",
+              QString("Moved decoder %1 to thread %2").arg(i).arg(QString::number(reinterpret_cast<quintptr>(thread))));
 
-    m_Decoder->moveToThread(&m_decodeThread);
-    debug("fc",
-          QString("Moved decoder to thread %1").arg(QString::number(reinterpret_cast<quintptr>(&m_decodeThread))));
+        if (m_segments.size() == 1) {
+            // Request & Receive signals for decoding (cross-thread communication)
+            connect(this, &FrameController::requestDecode, decoder, &VideoDecoder::loadFrames, Qt::QueuedConnection);
 
-    // Request & Receive signals for decoding (cross-thread communication)
-    connect(this, &FrameController::requestDecode, m_Decoder.get(), &VideoDecoder::loadFrames, Qt::QueuedConnection);
+            connect(decoder, &VideoDecoder::framesLoaded, this, &FrameController::onFrameDecoded, Qt::QueuedConnection);
 
-    connect(m_Decoder.get(), &VideoDecoder::framesLoaded, this, &FrameController::onFrameDecoded, Qt::QueuedConnection);
+            connect(this, &FrameController::requestSeek, decoder, &VideoDecoder::seek, Qt::QueuedConnection);
+
+            connect(decoder, &VideoDecoder::frameSeeked, this, &FrameController::onFrameSeeked, Qt::QueuedConnection);
+            continue;
+        }
 
-    connect(this, &FrameController::requestSeek, m_Decoder.get(), &VideoDecoder::seek, Qt::QueuedConnection);
+        // Segments are driven through dispatch(), which counts the completions it waits for
+        connect(
+            decoder,
+            &VideoDecoder::framesLoaded,
+            this,
+            [this, i](bool success) {
+                --m_segments[i].outstanding;
+                onFrameDecoded(success);
+                dispatchDeferred();
+            },
+            Qt::QueuedConnection);
+
+        connect(
+            decoder,
+            &VideoDecoder::frameSeeked,
+            this,
+            [this, i](int64_t pts) {
+                --m_segments[i].outstanding;
+                // A later seek went to another segment meanwhile, only its frame may be shown
+                if (i == m_active) {
+                    onFrameSeeked(pts);
+                } else {
+                    m_resumes.remove(pts);
+                }
+                dispatchDeferred();
+            },
+            Qt::QueuedConnection);
 
-    connect(m_Decoder.get(), &VideoDecoder::frameSeeked, this, &FrameController::onFrameSeeked, Qt::QueuedConnection);
+        connect(
+            decoder,
+            &VideoDecoder::rangeLoaded,
+            this,
+            [this, i](int64_t lastPts) { onRangeLoaded(i, lastPts); },
+            Qt::QueuedConnection);
+    }
+    setActive(0);
 
     // Request & Receive signals for uploading texture to buffer (same-thread communication)
     connect(this, &FrameController::requestUpload, m_window, &VideoWindow::uploadFrame, Qt::DirectConnection);
@@ -66,17 +138,22 @@ FrameController::FrameController(QObject* parent, VideoFileInfo videoFileInfo, i
             &FrameController::onRenderError,
             Qt::DirectConnection);
 
-    m_decodeThread.start();
+    for (Segment& segment : m_segments) {
+        segment.thread->start();
+    }
 }
 
 FrameController::~FrameController() {
     debug("fc", QString("Destructor for index %1").arg(m_index));
     // Ensure threads are stopped before destruction
-    m_decodeThread.quit();
-    m_decodeThread.wait();
+    for (Segment& segment : m_segments) {
+        segment.decoder->interrupt();
+        segment.thread->quit();
+        segment.thread->wait();
+    }
 
     // Clear unique pointers
-    m_Decoder.reset();
+    m_segments.clear();
 }
 
 AVRational FrameController::getTimeBase() {
@@ -94,7 +171,7 @@ void FrameController::start() {
 
     m_prefill = true;
     // Initial request to decode
-    emit requestDecode(m_frameQueue->getSize() / 2, 1);
+    decode(m_frameQueue->getSize() / 2, 1);
 }
 
 // Slots Definitions
@@ -103,6 +180,9 @@ void FrameController::onTimerTick(int64_t pts, int direction) {
 
     m_direction = direction;
 
+    // Follow the zoom, frames decoded from now on match what the view can show
+    applyProxyShift(m_proxyEnabled ? m_window->m_renderer->proxyLimit() : 0);
+
     // Render target frame if inside frameQueue
     FrameData* target = m_frameQueue->getHeadFrame(pts);
     if (target) {
@@ -124,7 +204,7 @@ void FrameController::onTimerTick(int64_t pts, int direction) {
         emit requestRender(m_index);
         emit endOfVideo(m_endOfVideo, m_index);
 
-    } else if (!m_prefill && !m_endOfVideo && pts >= 0 && pts < totalFrames()) {
+    } else if (!m_prefill && !m_endOfVideo && pts >= 0 && (m_live || pts < totalFrames())) {
         // If not already stalled, emit signal to VC to pause playback
         if (!m_stalled) {
             m_stalled = true;
@@ -136,11 +216,11 @@ void FrameController::onTimerTick(int64_t pts, int direction) {
                 m_decodeInProgress = true;
 
                 if (direction == 1) {
-                    emit requestSeek(pts, m_frameQueue->getSize() / 2);
+                    seek(pts, m_frameQueue->getSize() / 2);
                 } else {
                     // Safe guard for negative PTS
                     int64_t targetPts = std::max(pts - m_frameQueue->getSize() / 2, int64_t(0));
-                    emit requestSeek(targetPts, m_frameQueue->getSize() / 2);
+                    seek(targetPts, m_frameQueue->getSize() / 2);
                 }
             }
         }
@@ -161,18 +241,18 @@ void FrameController::onTimerStep(int64_t pts, int direction) {
 
     m_stepping = pts;
 
-    // Upload requested Frame
+    // Upload requested Frame, stepping always shows full resolution
     FrameData* target = m_frameQueue->getHeadFrame(pts);
-    if (target) {
+    if (target && target->proxyShift() == 0) {
         debug("fc", QString("Requested upload for frame with PTS %1").arg(pts));
-        emit requestUpload(target, m_index);
+        upload(target, pts);
     } else {
         if (direction == 1) {
-            emit requestSeek(pts, m_frameQueue->getSize() / 2);
+            seek(pts, m_frameQueue->getSize() / 2);
         } else {
             // Safe guard for negative PTS
             int64_t targetPts = std::max(pts - m_frameQueue->getSize() / 2, int64_t(0));
-            emit requestSeek(targetPts, m_frameQueue->getSize() / 2);
+            seek(targetPts, m_frameQueue->getSize() / 2);
         }
     }
 
@@ -196,7 +276,7 @@ void FrameController::onFrameDecoded(bool success) {
         } else {
             if (!m_decodeInProgress) {
                 m_decodeInProgress = true;
-                emit requestSeek(m_waitingPTS, m_frameQueue->getSize() / 2);
+                seek(m_waitingPTS, m_frameQueue->getSize() / 2);
             }
         }
     }
@@ -206,7 +286,7 @@ void FrameController::onFrameDecoded(bool success) {
         // Assume first frame has pts 0 and upload to buffer
         FrameData* firstFrame = m_frameQueue->getHeadFrame(0);
         if (firstFrame) {
-            emit requestUpload(firstFrame, m_index);
+            upload(firstFrame, 0);
         } else {
             warning("fc", QString("onFrameUploaded: No frame found for PTS 0 at index %1").arg(m_index));
         }
@@ -293,7 +373,7 @@ void FrameController::onFrameRendered() {
         if (future) {
             debug("fc", QString("Request upload for frame with PTS %1").arg(futurePts));
             m_ticking = -1;
-            emit requestUpload(future, m_index);
+            upload(future, futurePts);
         } else {
             warning("fc", QString("Cannot upload frame %1").arg(futurePts));
             m_ticking = -1;
@@ -307,13 +387,19 @@ void FrameController::onFrameRendered() {
                       .arg(framesToFill)
                       .arg(m_direction));
             m_decodeInProgress = true;
-            emit requestDecode(framesToFill, m_direction);
+            decode(framesToFill, m_direction);
         }
     }
 }
 
 void FrameController::onSeek(int64_t pts) {
     debug("fc", QString("Seeking to %1 for index %2").arg(pts).arg(m_index));
+
+    // Keep the frames around the position left behind, jumping back to it is then a cache hit
+    if (m_lastPTS >= 0 && std::abs(pts - m_lastPTS) > m_frameQueue->getSize() / 2) {
+        m_frameQueue->keepAround(m_lastPTS);
+    }
+
     // Check if frameQueue has the frame
     FrameData* frame = m_frameQueue->getHeadFrame(pts);
     m_seeking = pts;
@@ -326,25 +412,78 @@ void FrameController::onSeek(int64_t pts) {
     // Clear stall on new seek
     clearStall();
 
-    if (frame && !m_frameQueue->isStale(pts)) {
+    if (frame && !m_frameQueue->isStale(pts) && frame->proxyShift() == 0) {
         debug("fc", QString("Frame %1 found in queue, requesting upload").arg(pts));
-        emit requestUpload(frame, m_index);
+        upload(frame, pts);
 
         int direction = (frame->isEndFrame()) ? -1 : 1;
         int framesToFill = m_frameQueue->getEmpty(direction);
         debug("fc", QString("Requesting to fill %1 frames after seeking").arg(framesToFill));
         m_decodeInProgress = true;
-        emit requestDecode(framesToFill, direction);
+        decode(framesToFill, direction);
+
+    } else if (frame && frame->proxyShift() == 0 && !frame->isEndFrame()) {
+        // Cached in a range the decoder has left, show it and move the decoder behind the range
+        int64_t runEnd = m_frameQueue->cachedRunEnd(pts);
+        debug("fc", QString("Frame %1 cached up to %2, resuming decode after it").arg(pts).arg(runEnd));
+        upload(frame, pts);
+
+        int64_t resume = runEnd + 1;
+        if (totalFrames() <= 0 || resume < totalFrames()) {
+            int count = static_cast<int>(std::max<int64_t>(pts + m_frameQueue->getSize() / 2 - runEnd, 1));
+            m_resumes.insert(resume);
+            m_decodeInProgress = true;
+            seek(resume, count);
+        }
 
     } else {
         debug("fc", QString("Frame %1 not in queue, requesting seek").arg(pts));
-        emit requestSeek(pts, m_frameQueue->getSize() / 2);
+        seek(pts, m_frameQueue->getSize() / 2);
+    }
+}
+
+void FrameController::setProxyEnabled(bool enabled) {
+    m_proxyEnabled = enabled;
+    if (enabled) {
+        return;
+    }
+    applyProxyShift(0);
+
+    // Queued so a seek or step issued together with the pause goes first and makes the refresh unnecessary
+    QMetaObject::invokeMethod(this, [this]() { refreshProxyFrame(); }, Qt::QueuedConnection);
+}
+
+void FrameController::refreshProxyFrame() {
+    if (m_proxyEnabled || m_stalled || m_lastPTS < 0 || m_seeking != -1 || m_stepping != -1) {
+        return;
+    }
+    FrameData* shown = m_frameQueue->getHeadFrame(m_lastPTS);
+    if (shown && shown->proxyShift() > 0) {
+        debug("fc", QString("Replacing proxy frame %1 at full resolution").arg(m_lastPTS));
+        m_stepping = m_lastPTS;
+        seek(m_lastPTS, m_frameQueue->getSize() / 2);
+    }
+}
+
+void FrameController::applyProxyShift(int shift) {
+    if (shift == m_proxyShift) {
+        return;
+    }
+    debug("fc", QString("Proxy shift %1 for index %2").arg(shift).arg(m_index));
+    m_proxyShift = shift;
+    for (Segment& segment : m_segments) {
+        segment.decoder->setProxyShift(shift);
     }
 }
 
 void FrameController::onFrameSeeked(int64_t pts) {
     debug("fc", QString("onFrameSeeked called for index %1 with PTS %2").arg(m_index).arg(pts));
 
+    // Decoder moved behind a cached range, the frame on screen already came from the cache
+    if (m_resumes.remove(pts)) {
+        return;
+    }
+
     int64_t targetPts = pts;
     if (m_stepping != -1) {
         targetPts = m_stepping;
@@ -366,10 +505,24 @@ void FrameController::onFrameSeeked(int64_t pts) {
         m_endOfVideo = false;
     }
 
-    emit requestUpload(frameSeeked, m_index);
+    upload(frameSeeked, targetPts);
     emit endOfVideo(m_endOfVideo, m_index);
 }
 
+// Pinned while the window and the compare controller copy it, the decoder cannot rewrite it underneath them
+void FrameController::upload(FrameData* frame, int64_t pts) {
+    for (int attempt = 0; attempt < 2 && frame; ++attempt) {
+        FramePin pin(frame, pts);
+        if (pin) {
+            emit requestUpload(frame, m_index);
+            return;
+        }
+        // Evicted or superseded since it was looked up, a newer copy may be cached by now
+        frame = m_frameQueue->getHeadFrame(pts);
+    }
+    warning("fc", QString("Frame %1 was replaced before it could be uploaded").arg(pts));
+}
+
 void FrameController::onRenderError() {
     warning("fc", QString("onRenderError for index %1").arg(m_index));
     ErrorReporter::instance().report("Rendering error occurred", LogLevel::Error);
@@ -389,4 +542,221 @@ void FrameController::clearStall() {
     m_stalled = false;
     m_waitingPTS = -1;
     emit decoderStalled(m_index, false);
-}
\ No newline at end of file
+}
+void FrameController::decode(int numFrames, int direction) {
+    if (m_segments.size() == 1) {
+        emit requestDecode(numFrames, direction);
+        return;
+    }
+    submit({false, -1, numFrames, direction});
+}
+
+void FrameController::seek(int64_t pts, int loadCount) {
+    if (m_segments.size() == 1) {
+        emit requestSeek(pts, loadCount);
+        return;
+    }
+    submit({true, pts, loadCount, 1});
+}
+
+void FrameController::submit(const DecodeRequest& request) {
+    // Loads keep their order behind waiting requests, a seek only waits for its own segment
+    if ((request.seek || m_deferred.empty()) && canDispatch(request)) {
+        dispatch(request);
+        return;
+    }
+
+    // Scrubbing only ever needs the latest target
+    if (request.seek && !m_deferred.empty() && m_deferred.back().seek) {
+        debug("fc", QString("Seek to %1 replaces queued seek to %2").arg(request.pts).arg(m_deferred.back().pts));
+        m_deferred.back() = request;
+    } else {
+        m_deferred.push_back(request);
+    }
+}
+
+bool FrameController::canDispatch(const DecodeRequest& request) const {
+    if (request.seek) {
+        return m_segments[routeSeek(seekStart(request))].outstanding == 0;
+    }
+    // Loads continue from the active segment's position, which a batch in flight has not settled yet
+    return m_batch.empty() && m_segments[m_active].outstanding == 0;
+}
+
+void FrameController::dispatchDeferred() {
+    // A dispatch drops superseded seeks and moves the active segment, so every pass starts from the front
+    bool dispatched = true;
+    while (dispatched) {
+        dispatched = false;
+        for (auto it = m_deferred.begin(); it != m_deferred.end(); ++it) {
+            if ((it->seek || it == m_deferred.begin()) && canDispatch(*it)) {
+                DecodeRequest request = *it;
+                m_deferred.erase(it);
+                dispatch(request);
+                dispatched = true;
+                break;
+            }
+        }
+    }
+}
+
+void FrameController::dispatch(const DecodeRequest& request) {
+    if (request.seek) {
+        size_t segment = routeSeek(seekStart(request));
+        debug("fc", QString("Seek to %1 routed to decoder %2").arg(request.pts).arg(segment));
+
+        // Older seeks still waiting are superseded, so is a batch still loading at the old position
+        m_deferred.erase(std::remove_if(m_deferred.begin(),
+                                        m_deferred.end(),
+                                        [](const DecodeRequest& waiting) { return waiting.seek; }),
+                         m_deferred.end());
+        if (!m_batch.empty()) {
+            m_batchSuperseded = true;
+        }
+        setActive(segment);
+
+        // VideoDecoder::seek() reports the load and then the seek itself
+        m_segments[segment].outstanding += 2;
+        VideoDecoder* decoder = m_segments[segment].decoder.get();
+        int64_t pts = request.pts;
+        int count = request.count;
+        QMetaObject::invokeMethod(
+            decoder, [decoder, pts, count]() { decoder->seek(pts, count); }, Qt::QueuedConnection);
+        return;
+    }
+
+    if (request.direction == 1 && m_intraOnly && dispatchBatch(request.count)) {
+        return;
+    }
+
+    m_segments[m_active].outstanding += 1;
+    VideoDecoder* decoder = m_segments[m_active].decoder.get();
+    int count = request.count;
+    int direction = request.direction;
+    QMetaObject::invokeMethod(
+        decoder, [decoder, count, direction]() { decoder->loadFrames(count, direction); }, Qt::QueuedConnection);
+}
+
+/**
+ * @brief Splits a forward load over every segment, each decoding an adjacent range in parallel.
+ *
+ * Only used for intra-only sources, where starting a range anywhere costs no GOP walk.
+ * @return false when the batch is too small to be worth splitting
+ */
+bool FrameController::dispatchBatch(int numFrames) {
+    const int minFramesPerPart = 4;
+
+    int64_t first = m_segments[m_active].decoder->position();
+    if (totalFrames() > 0) {
+        numFrames = static_cast<int>(std::min<int64_t>(numFrames, totalFrames() - first));
+    }
+    // Segments still busy with a seek elsewhere sit the batch out
+    std::vector<size_t> idle;
+    for (size_t i = 0; i < m_segments.size(); ++i) {
+        size_t segment = (m_active + i) % m_segments.size();
+        if (m_segments[segment].outstanding == 0) {
+            idle.push_back(segment);
+        }
+    }
+    int parts = std::min(static_cast<int>(idle.size()), numFrames / minFramesPerPart);
+    if (parts < 2) {
+        return false;
+    }
+
+    // The active segment continues where it stopped, the others seek to the ranges after it
+    m_batch.clear();
+    for (int i = 0; i < parts; ++i) {
+        int count = numFrames / parts + (i < numFrames % parts ? 1 : 0);
+        m_batch.push_back({idle[i], first, count, -1});
+        first += count;
+    }
+
+    m_batchOutstanding = parts;
+    m_batchSuperseded = false;
+    for (const RangePart& part : m_batch) {
+        m_segments[part.segment].outstanding += 1;
+        VideoDecoder* decoder = m_segments[part.segment].decoder.get();
+        int64_t partFirst = part.first;
+        int count = part.count;
+        QMetaObject::invokeMethod(
+            decoder, [decoder, partFirst, count]() { decoder->loadRange(partFirst, count); }, Qt::QueuedConnection);
+    }
+    debug("fc", QString("Loading %1 frames over %2 decoders").arg(numFrames).arg(parts));
+    return true;
+}
+
+void FrameController::onRangeLoaded(size_t segment, int64_t lastPts) {
+    --m_segments[segment].outstanding;
+    for (RangePart& part : m_batch) {
+        if (part.segment == segment) {
+            part.last = lastPts;
+        }
+    }
+    if (--m_batchOutstanding > 0) {
+        return;
+    }
+
+    // After a seek the tail belongs to the seeking segment, the ranges stay cached but publish nothing
+    if (!m_batchSuperseded) {
+        // Publish the frames up to the first range that came up short, later ones cannot be reached
+        int64_t tail = -1;
+        size_t active = m_active;
+        for (const RangePart& part : m_batch) {
+            if (part.last < 0) {
+                break;
+            }
+            tail = part.last;
+            active = part.segment;
+            if (part.last != part.first + part.count - 1) {
+                break;
+            }
+        }
+        setActive(active);
+        m_frameQueue->updateTail(tail);
+    }
+    m_batch.clear();
+
+    onFrameDecoded(true);
+    dispatchDeferred();
+}
+
+/**
+ * @brief Picks the segment to serve a seek starting at pts.
+ *
+ * A decoder parked shortly before pts gets there by decoding on. Otherwise the decoder owning the
+ * region of the timeline pts falls in seeks, leaving the others where they are.
+ */
+size_t FrameController::routeSeek(int64_t pts) const {
+    int total = m_frameMeta->totalFrames();
+    int64_t regionLength = std::max<int64_t>(total / static_cast<int>(m_segments.size()), 1);
+    if (total <= 0) {
+        regionLength = m_frameQueue->getSize();
+    }
+
+    size_t nearest = m_segments.size();
+    int64_t nearestPosition = -1;
+    for (size_t i = 0; i < m_segments.size(); ++i) {
+        int64_t position = m_segments[i].decoder->position();
+        if (position <= pts && pts - position < regionLength && position > nearestPosition) {
+            nearest = i;
+            nearestPosition = position;
+        }
+    }
+    if (nearest < m_segments.size()) {
+        return nearest;
+    }
+
+    return std::min(static_cast<size_t>(pts / regionLength), m_segments.size() - 1);
+}
+
+// Seeks without a load count start a quarter queue before the target, see VideoDecoder::seek()
+int64_t FrameController::seekStart(const DecodeRequest& request) const {
+    return request.count == -1 ? std::max<int64_t>(request.pts - m_frameQueue->getSize() / 4, 0) : request.pts;
+}
+
+void FrameController::setActive(size_t segment) {
+    m_active = segment;
+    for (size_t i = 0; i < m_segments.size(); ++i) {
+        m_segments[i].decoder->setPublishTail(i == segment);
+    }
+}
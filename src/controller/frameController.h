@@ -1,9 +1,12 @@
 #pragma once
 
 #include <QElapsedTimer>
+#include <QSet>
 #include <QThread>
 #include <QtConcurrent>
+#include <deque>
 #include <utility>
+#include <vector>
 #include "decoder/videoDecoder.h"
 #include "frames/frameData.h"
 #include "frames/frameMeta.h"
@@ -42,6 +45,12 @@ class FrameController : public QObject {
     int totalFrames();
     int64_t getDuration();
 
+    // Reading from stdin or a named pipe, the length stays unknown while frames keep arriving
+    bool isLive() const { return m_live; }
+
+    // Lets playback decode proxies sized to the view. Disabling it brings the frame on screen back to full resolution.
+    void setProxyEnabled(bool enabled);
+
   public slots:
     // Receive signals from decoder and renderer
     void onFrameDecoded(bool success);
@@ -62,8 +71,14 @@ class FrameController : public QObject {
     void decoderStalled(int index, bool stalled);
 
   private:
-    // YUVReader to read frames from video file
-    std::unique_ptr<VideoDecoder> m_Decoder = nullptr;
+    // Decoders opened on the same file, each on its own thread. With more than one, every decoder
+    // parks in its own region of the timeline and seeks go to whichever sits closest to the target.
+    struct Segment {
+        std::unique_ptr<VideoDecoder> decoder;
+        std::unique_ptr<QThread> thread;
+        int outstanding = 0; // Completion signals still expected from the decoder
+    };
+    std::vector<Segment> m_segments;
 
     // For display
     VideoWindow* m_window = nullptr;
@@ -73,9 +88,6 @@ class FrameController : public QObject {
 
     std::shared_ptr<FrameMeta> m_frameMeta;
 
-    // Thread for writing frames object
-    QThread m_decodeThread;
-
     // Last PTS of the frame rendered
     int64_t m_lastPTS = -1;
 
@@ -96,5 +108,51 @@ class FrameController : public QObject {
     bool m_stalled = false;
     int64_t m_waitingPTS = -1;
 
+    // Seeks that only reposition the decoder after a cache hit, their completion shows nothing
+    QSet<int64_t> m_resumes;
+
     void clearStall();
+    void upload(FrameData* frame, int64_t pts);
+
+    bool m_proxyEnabled = false;
+    int m_proxyShift = 0; // Shift last handed to the decoders
+    void applyProxyShift(int shift);
+    void refreshProxyFrame();
+
+    // Requests to the decoders. Each segment works on one request at a time. A seek goes out as soon
+    // as the segment it is routed to is idle, while the others keep refilling their regions of the
+    // shared FrameQueue; loads wait for the active segment. Queued seeks collapse into the latest target.
+    struct DecodeRequest {
+        bool seek;
+        int64_t pts;
+        int count;
+        int direction;
+    };
+    std::deque<DecodeRequest> m_deferred;
+    size_t m_active = 0; // Segment holding the frames around the playback position
+    bool m_intraOnly = false;
+    bool m_live = false;
+
+    // Forward batch split over several segments, the tail moves once every part is in
+    struct RangePart {
+        size_t segment;
+        int64_t first;
+        int count;
+        int64_t last;
+    };
+    std::vector<RangePart> m_batch;
+    int m_batchOutstanding = 0;
+    bool m_batchSuperseded = false; // A seek moved the playback position while the batch was loading
+
+    void decode(int numFrames, int direction);
+    void seek(int64_t pts, int loadCount);
+    void submit(const DecodeRequest& request);
+    bool canDispatch(const DecodeRequest& request) const;
+    void dispatch(const DecodeRequest& request);
+    void dispatchDeferred();
+    bool dispatchBatch(int numFrames);
+    void onRangeLoaded(size_t segment, int64_t lastPts);
+    int64_t seekStart(const DecodeRequest& request) const;
+    size_t routeSeek(int64_t pts) const;
+    void setActive(size_t segment);
 };
@@ -1,14 +1,22 @@
 #include "videoController.h"
 #include <QTimer>
+#include <algorithm>
+#include "utils/appConfig.h"
 #include "utils/debugManager.h"
 
 VideoController::VideoController(QObject* parent,
                                  std::shared_ptr<CompareController> compareController,
                                  std::vector<VideoFileInfo> videoFiles) :
     QObject(parent),
-    m_compareController(compareController) {
+    m_compareController(compareController),
+    m_thumbnails(std::make_shared<ThumbnailEngine>()) {
     debug("vc", QString("Constructor invoked with %1 videoFiles").arg(videoFiles.size()));
 
+    // Thumbnail builds back off while playback needs the disk and the cores
+    auto updateThumbnailLoad = [this]() { m_thumbnails->setPlaybackLoad(m_isPlaying, m_isBuffering); };
+    connect(this, &VideoController::isPlayingChanged, this, updateThumbnailLoad);
+    connect(this, &VideoController::isBufferingChanged, this, updateThumbnailLoad);
+
     // Creating FC for each video
     for (const auto& videoFile : videoFiles) {
         addVideo(videoFile);
@@ -80,10 +88,20 @@ void VideoController::addVideo(VideoFileInfo videoFile) {
     m_totalFrames = std::max(m_totalFrames, frameController->totalFrames());
     emit totalFramesChanged();
 
-    m_realEndMs =
-        (static_cast<double>(m_totalFrames - 1) / static_cast<double>(m_totalFrames)) * static_cast<double>(m_duration);
+    if (m_totalFrames > 0) {
+        m_realEndMs = (static_cast<double>(m_totalFrames - 1) / static_cast<double>(m_totalFrames)) *
+                      static_cast<double>(m_duration);
+    }
     debug("vc", QString("Real end time in ms: %1").arg(m_realEndMs));
 
+    // Live streams can only be read once, the filmstrip would need a second reader
+    if (frameController->isLive()) {
+        m_isLive = true;
+        emit isLiveChanged();
+    } else {
+        m_thumbnails->addVideo(m_fcIndex, videoFile, frameController->totalFrames());
+    }
+
     m_frameControllers.push_back(std::move(frameController));
     debug("vc", QString("FrameController count now: %1").arg(m_frameControllers.size()));
 
@@ -144,6 +162,7 @@ void VideoController::removeVideo(int index) {
 
     // Remove the FrameController at the specified index
     m_frameControllers[index].reset();
+    m_thumbnails->removeVideo(index);
     m_realCount--;
 
     // Recalculate duration based on remaining videos
@@ -156,6 +175,13 @@ void VideoController::removeVideo(int index) {
     m_duration = newDuration;
     emit durationChanged();
 
+    bool live = std::any_of(
+        m_frameControllers.begin(), m_frameControllers.end(), [](const auto& fc) { return fc && fc->isLive(); });
+    if (live != m_isLive) {
+        m_isLive = live;
+        emit isLiveChanged();
+    }
+
     // If all remaining FCs are ready, keep ready=true, otherwise false
     bool allReady = (m_realCount > 0) ? (m_readyFCs.size() == m_realCount) : false;
     if (m_ready != allReady) {
@@ -293,6 +319,7 @@ void VideoController::play() {
 
     m_isPlaying = true;
     emit isPlayingChanged();
+    setProxyEnabled(AppConfig::instance().getProxyMode() && !m_diffMode);
 
     if (m_direction == 1) {
         emit playForwardTimer();
@@ -305,6 +332,15 @@ void VideoController::pause() {
     m_isPlaying = false;
     emit isPlayingChanged();
     emit pauseTimer();
+    setProxyEnabled(false);
+}
+
+void VideoController::setProxyEnabled(bool enabled) {
+    for (auto& fc : m_frameControllers) {
+        if (fc) {
+            fc->setProxyEnabled(enabled);
+        }
+    }
 }
 
 void VideoController::stepForward() {
@@ -389,7 +425,8 @@ void VideoController::seekTo(double timeMs) {
 
     std::vector<int64_t> seekPts;
 
-    double target = (timeMs >= m_duration) ? m_realEndMs : timeMs;
+    // Live streams have no known end to clamp to
+    double target = (m_duration > 0 && timeMs >= m_duration) ? m_realEndMs : timeMs;
 
     for (size_t i = 0; i < m_frameControllers.size(); ++i) {
         // Convert timeMs to PTS using the FC's timebase
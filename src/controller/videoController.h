@@ -10,6 +10,7 @@
 #include "controller/compareController.h"
 #include "controller/frameController.h"
 #include "controller/timer.h"
+#include "decoder/thumbnailEngine.h"
 #include "decoder/videoDecoder.h"
 #include "frames/frameData.h"
 #include "frames/frameMeta.h"
@@ -30,6 +31,7 @@ class VideoController : public QObject {
     Q_PROPERTY(bool ready READ ready NOTIFY readyChanged)
     Q_PROPERTY(bool isSeeking READ isSeeking NOTIFY seekingChanged)
     Q_PROPERTY(bool isBuffering READ isBuffering NOTIFY isBufferingChanged)
+    Q_PROPERTY(bool isLive READ isLive NOTIFY isLiveChanged)
 
   public:
     VideoController(QObject* parent,
@@ -46,10 +48,14 @@ class VideoController : public QObject {
     bool ready() const { return m_ready; }
     bool isSeeking() const { return m_isSeeking; }
     bool isBuffering() const { return m_isBuffering; }
+    // A video streams from stdin or a pipe, its end is not known yet
+    bool isLive() const { return m_isLive; }
 
     void addVideo(VideoFileInfo videoFileInfo);
     void setUpTimer();
 
+    std::shared_ptr<ThumbnailEngine> thumbnailEngine() const { return m_thumbnails; }
+
   public slots:
     void onReady(int index);
     void onFCStartOfVideo(int index);
@@ -93,8 +99,12 @@ class VideoController : public QObject {
     void readyChanged();
     void seekingChanged();
     void isBufferingChanged();
+    void isLiveChanged();
 
   private:
+    // Proxies are only decoded while playing and never in diff mode, compared frames must be exact
+    void setProxyEnabled(bool enabled);
+
     std::vector<std::unique_ptr<FrameController>> m_frameControllers;
     std::vector<AVRational> m_timeBases;
 
@@ -117,6 +127,7 @@ class VideoController : public QObject {
     int64_t m_duration = 0;
 
     int m_totalFrames = 0;
+    bool m_isLive = false;
 
     int64_t m_currentTimeMs = 0;
     int64_t m_realEndMs = 0;
@@ -137,4 +148,7 @@ class VideoController : public QObject {
     bool m_isBuffering = false;
 
     std::shared_ptr<CompareController> m_compareController;
+
+    // Filmstrips for the timeline, built in the background per video
+    std::shared_ptr<ThumbnailEngine> m_thumbnails;
 };
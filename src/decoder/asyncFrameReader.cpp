@@ -0,0 +1,160 @@
+#include "asyncFrameReader.h"
+#include "utils/debugManager.h"
+
+#ifdef YUVIZ_HAVE_LIBURING
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+constexpr unsigned kQueueDepth = 16;
+constexpr int64_t kDirectAlignment = 4096;
+// Kernel reads are capped below 2 GiB, larger frames complete over several requests
+constexpr int64_t kMaxReadSize = 1LL << 30;
+} // namespace
+
+AsyncFrameReader::~AsyncFrameReader() {
+    close();
+}
+
+bool AsyncFrameReader::open(const QString& fileName) {
+    close();
+
+    QByteArray path = fileName.toLocal8Bit();
+    m_fd = ::open(path.constData(), O_RDONLY | O_CLOEXEC);
+    if (m_fd < 0) {
+        return false;
+    }
+
+    int ret = io_uring_queue_init(kQueueDepth, &m_ring, 0);
+    if (ret < 0) {
+        // Old kernels and seccomp filtered containers refuse the ring
+        debug("vd", QString("io_uring unavailable (%1), using synchronous reads").arg(strerror(-ret)));
+        close();
+        return false;
+    }
+    m_ringReady = true;
+
+    // Not every filesystem accepts O_DIRECT, the buffered descriptor covers those
+    m_directFd = ::open(path.constData(), O_RDONLY | O_CLOEXEC | O_DIRECT);
+    debug("vd", QString("io_uring frame reader open, O_DIRECT %1").arg(m_directFd >= 0 ? "on" : "off"));
+    return true;
+}
+
+void AsyncFrameReader::close() {
+    if (m_ringReady) {
+        io_uring_queue_exit(&m_ring);
+        m_ringReady = false;
+    }
+    if (m_directFd >= 0) {
+        ::close(m_directFd);
+        m_directFd = -1;
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+bool AsyncFrameReader::isOpen() const {
+    return m_ringReady;
+}
+
+void AsyncFrameReader::queue(Read& read) {
+    io_uring_sqe* sqe = io_uring_get_sqe(&m_ring);
+    while (!sqe) {
+        io_uring_submit(&m_ring);
+        sqe = io_uring_get_sqe(&m_ring);
+    }
+
+    bool aligned = read.offset % kDirectAlignment == 0 && read.size % kDirectAlignment == 0 &&
+                   reinterpret_cast<uintptr_t>(read.dst) % kDirectAlignment == 0;
+    int fd = m_directFd >= 0 && aligned ? m_directFd : m_fd;
+    unsigned size = static_cast<unsigned>(std::min(read.size, kMaxReadSize));
+
+    io_uring_prep_read(sqe, fd, read.dst, size, static_cast<uint64_t>(read.offset));
+    io_uring_sqe_set_data(sqe, &read);
+}
+
+bool AsyncFrameReader::read(std::vector<Read>& reads) {
+    if (!m_ringReady) {
+        return false;
+    }
+
+    size_t next = 0;
+    unsigned inFlight = 0;
+    bool ok = true;
+
+    while ((ok && next < reads.size()) || inFlight > 0) {
+        while (ok && next < reads.size() && inFlight < kQueueDepth) {
+            queue(reads[next++]);
+            ++inFlight;
+        }
+        io_uring_submit(&m_ring);
+
+        io_uring_cqe* cqe = nullptr;
+        int ret = io_uring_wait_cqe(&m_ring, &cqe);
+        if (ret == -EINTR) {
+            continue;
+        }
+        if (ret < 0) {
+            // Requests still in flight would land in slots after we return, retire the ring instead
+            warning("vd", QString("io_uring wait failed: %1").arg(strerror(-ret)));
+            close();
+            return false;
+        }
+
+        Read* read = static_cast<Read*>(io_uring_cqe_get_data(cqe));
+        int res = cqe->res;
+        io_uring_cqe_seen(&m_ring, cqe);
+        --inFlight;
+
+        if (res == -EINTR || res == -EAGAIN) {
+            queue(*read);
+            ++inFlight;
+        } else if (res == -EINVAL && m_directFd >= 0) {
+            // The filesystem rejected the direct read, stay buffered from now on
+            debug("vd", "O_DIRECT read rejected, falling back to buffered reads");
+            ::close(m_directFd);
+            m_directFd = -1;
+            queue(*read);
+            ++inFlight;
+        } else if (res <= 0) {
+            ok = false;
+        } else {
+            read->offset += res;
+            read->dst += res;
+            read->size -= res;
+            // Short reads continue where they stopped, usually through the buffered descriptor
+            if (read->size > 0) {
+                queue(*read);
+                ++inFlight;
+            }
+        }
+    }
+
+    return ok;
+}
+
+#else
+
+AsyncFrameReader::~AsyncFrameReader() = default;
+
+bool AsyncFrameReader::open(const QString&) {
+    return false;
+}
+
+void AsyncFrameReader::close() {
+}
+
+bool AsyncFrameReader::isOpen() const {
+    return false;
+}
+
+bool AsyncFrameReader::read(std::vector<Read>&) {
+    return false;
+}
+
+#endif
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QString>
+#include <cstdint>
+#include <vector>
+
+#ifdef YUVIZ_HAVE_LIBURING
+#include <liburing.h>
+#endif
+
+// Reads whole frames of raw YUV and Y4M files through io_uring, keeping several reads in flight
+// straight into frame queue slots. Reads whose offset, length and buffer are page aligned bypass
+// the page cache with O_DIRECT, in practice only raw files whose frame size is a multiple of the
+// page size: Y4M payloads follow a frame header and 4:2:0 frames such as 1080p are not page
+// multiples. Without liburing, or when the kernel refuses a ring, open() fails and callers stay on
+// their synchronous path.
+class AsyncFrameReader {
+  public:
+    struct Read {
+        int64_t offset;
+        uint8_t* dst;
+        int64_t size;
+    };
+
+    AsyncFrameReader() = default;
+    ~AsyncFrameReader();
+
+    AsyncFrameReader(const AsyncFrameReader&) = delete;
+    AsyncFrameReader& operator=(const AsyncFrameReader&) = delete;
+
+    bool open(const QString& fileName);
+    void close();
+    bool isOpen() const;
+
+    // Performs every read and returns once all of them completed. The entries are consumed.
+    // @return false when a read failed or ran past the end of the file
+    bool read(std::vector<Read>& reads);
+
+  private:
+#ifdef YUVIZ_HAVE_LIBURING
+    void queue(Read& read);
+
+    io_uring m_ring{};
+    bool m_ringReady = false;
+    int m_fd = -1;
+    int m_directFd = -1;
+#endif
+};
@@ -0,0 +1,108 @@
+#include "keyframeIndex.h"
+#include <QString>
+#include <QtConcurrent>
+#include <algorithm>
+#include "utils/debugManager.h"
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+KeyframeIndex::~KeyframeIndex() {
+    reset();
+}
+
+void KeyframeIndex::build(const std::string& fileName, int streamIndex, ReadyCallback onReady) {
+    reset();
+    m_future = QtConcurrent::run([this, fileName, streamIndex, onReady]() { run(fileName, streamIndex, onReady); });
+}
+
+void KeyframeIndex::load(std::vector<Entry> entries) {
+    reset();
+    setEntries(std::move(entries));
+}
+
+void KeyframeIndex::reset() {
+    m_cancel.store(true, std::memory_order_release);
+    m_future.waitForFinished();
+    m_cancel.store(false, std::memory_order_release);
+
+    m_ready.store(false, std::memory_order_release);
+    m_entries.clear();
+    m_keyframes.clear();
+}
+
+bool KeyframeIndex::keyframeBefore(int64_t pts, Entry& keyframe) const {
+    if (!isReady() || m_keyframes.empty()) {
+        return false;
+    }
+
+    auto it = std::upper_bound(m_keyframes.begin(), m_keyframes.end(), pts, [](int64_t value, const Entry& entry) {
+        return value < entry.pts;
+    });
+    if (it == m_keyframes.begin()) {
+        return false;
+    }
+
+    keyframe = *std::prev(it);
+    return true;
+}
+
+void KeyframeIndex::run(const std::string& fileName, int streamIndex, const ReadyCallback& onReady) {
+    // A separate demuxer instance, the decoder's own one keeps serving playback meanwhile
+    AVFormatContext* formatContext = nullptr;
+    if (avformat_open_input(&formatContext, fileName.c_str(), nullptr, nullptr) < 0) {
+        warning("vd", QString("Keyframe index could not open %1").arg(QString::fromStdString(fileName)));
+        return;
+    }
+
+    if (avformat_find_stream_info(formatContext, nullptr) < 0 || streamIndex < 0 ||
+        streamIndex >= static_cast<int>(formatContext->nb_streams)) {
+        warning("vd", "Keyframe index could not find the video stream");
+        avformat_close_input(&formatContext);
+        return;
+    }
+
+    // Only the video packets are of interest, let the demuxer skip everything else
+    for (unsigned int i = 0; i < formatContext->nb_streams; ++i) {
+        if (static_cast<int>(i) != streamIndex) {
+            formatContext->streams[i]->discard = AVDISCARD_ALL;
+        }
+    }
+
+    std::vector<Entry> entries;
+    AVPacket* packet = av_packet_alloc();
+    while (packet && !m_cancel.load(std::memory_order_acquire) && av_read_frame(formatContext, packet) >= 0) {
+        if (packet->stream_index == streamIndex) {
+            entries.push_back({packet->pts, packet->dts, packet->pos, (packet->flags & AV_PKT_FLAG_KEY) != 0});
+        }
+        av_packet_unref(packet);
+    }
+    av_packet_free(&packet);
+    avformat_close_input(&formatContext);
+
+    if (m_cancel.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    setEntries(std::move(entries));
+    if (onReady) {
+        onReady(m_entries);
+    }
+}
+
+void KeyframeIndex::setEntries(std::vector<Entry> entries) {
+    std::vector<Entry> keyframes;
+    for (const Entry& entry : entries) {
+        if (entry.keyframe && entry.pts != AV_NOPTS_VALUE) {
+            keyframes.push_back(entry);
+        }
+    }
+    std::sort(keyframes.begin(), keyframes.end(), [](const Entry& a, const Entry& b) { return a.pts < b.pts; });
+
+    debug("vd", QString("Keyframe index ready: %1 packets, %2 keyframes").arg(entries.size()).arg(keyframes.size()));
+
+    m_entries = std::move(entries);
+    m_keyframes = std::move(keyframes);
+    m_ready.store(true, std::memory_order_release);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QFuture>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Packet index of one video stream, built once per file on a background thread.
+// Timestamps are in the stream's time base.
+class KeyframeIndex {
+  public:
+    struct Entry {
+        int64_t pts;
+        int64_t dts;
+        int64_t pos;
+        bool keyframe;
+    };
+
+    KeyframeIndex() = default;
+    ~KeyframeIndex();
+
+    // Called on the worker thread once a build completes
+    using ReadyCallback = std::function<void(const std::vector<Entry>& entries)>;
+
+    // Starts walking the packets of the given stream on the global thread pool
+    void build(const std::string& fileName, int streamIndex, ReadyCallback onReady = {});
+
+    // Adopts packets recorded by an earlier build, e.g. from the metadata cache
+    void load(std::vector<Entry> entries);
+
+    // Cancels a running build and drops the index
+    void reset();
+
+    bool isReady() const { return m_ready.load(std::memory_order_acquire); }
+
+    // Finds the last keyframe presented at or before pts, only valid once isReady()
+    bool keyframeBefore(int64_t pts, Entry& keyframe) const;
+
+    // Packets in decode order, only valid once isReady()
+    const std::vector<Entry>& entries() const { return m_entries; }
+
+  private:
+    void run(const std::string& fileName, int streamIndex, const ReadyCallback& onReady);
+    void setEntries(std::vector<Entry> entries);
+
+    QFuture<void> m_future;
+    std::atomic<bool> m_cancel = false;
+    std::atomic<bool> m_ready = false;
+
+    std::vector<Entry> m_entries;
+    // Keyframes sorted by presentation time
+    std::vector<Entry> m_keyframes;
+};
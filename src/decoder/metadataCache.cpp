@@ -0,0 +1,226 @@
+#include "metadataCache.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+#include "utils/debugManager.h"
+
+namespace {
+constexpr quint32 kMagic = 0x59565a43; // "YVZC"
+// 2: compressed streams store the pixel format of the queue slots, not the decoder's
+// 3: the stream start time, frame indices count from it
+constexpr quint32 kVersion = 3;
+constexpr qint64 kFingerprintBytes = 64 * 1024;
+constexpr qint64 kMaxCacheBytes = 256LL * 1024 * 1024;
+
+// Serializes writers and eviction, readers only ever see complete files thanks to QSaveFile
+QMutex s_writeMutex;
+
+void writeMeta(QDataStream& out, const FrameMeta& meta) {
+    out << qint32(meta.yWidth()) << qint32(meta.yHeight()) << qint32(meta.uvWidth()) << qint32(meta.uvHeight())
+        << qint32(meta.format()) << qint32(meta.timeBase().num) << qint32(meta.timeBase().den)
+        << qint32(meta.sampleAspectRatio().num) << qint32(meta.sampleAspectRatio().den) << qint32(meta.colorRange())
+        << qint32(meta.colorSpace()) << QString::fromStdString(meta.codecName()) << qint64(meta.duration())
+        << qint32(meta.totalFrames());
+}
+
+void readMeta(QDataStream& in, FrameMeta& meta) {
+    qint32 yWidth, yHeight, uvWidth, uvHeight, format, tbNum, tbDen, sarNum, sarDen, range, space, totalFrames;
+    QString codecName;
+    qint64 duration;
+    in >> yWidth >> yHeight >> uvWidth >> uvHeight >> format >> tbNum >> tbDen >> sarNum >> sarDen >> range >> space >>
+        codecName >> duration >> totalFrames;
+
+    meta.setYWidth(yWidth);
+    meta.setYHeight(yHeight);
+    meta.setUVWidth(uvWidth);
+    meta.setUVHeight(uvHeight);
+    meta.setPixelFormat(static_cast<AVPixelFormat>(format));
+    meta.setTimeBase({tbNum, tbDen});
+    meta.setSampleAspectRatio({sarNum, sarDen});
+    meta.setColorRange(static_cast<AVColorRange>(range));
+    meta.setColorSpace(static_cast<AVColorSpace>(space));
+    meta.setCodecName(codecName.toStdString());
+    meta.setDuration(duration);
+    meta.setTotalFrames(totalFrames);
+}
+} // namespace
+
+QString MetadataCache::cacheDirectory() {
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/yuviz";
+}
+
+bool MetadataCache::makeKey(const QString& fileName, Key& key) {
+    QFileInfo info(fileName);
+    QFile file(fileName);
+    if (!info.isFile() || !file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    key.path = info.canonicalFilePath();
+    key.size = info.size();
+    key.modified = info.lastModified().toMSecsSinceEpoch();
+
+    // Size and mtime alone miss in-place rewrites, hash both ends of the file as well
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(file.read(kFingerprintBytes));
+    if (key.size > kFingerprintBytes && file.seek(std::max(key.size - kFingerprintBytes, kFingerprintBytes))) {
+        hash.addData(file.read(kFingerprintBytes));
+    }
+    key.fingerprint = hash.result();
+    return true;
+}
+
+QString MetadataCache::entryPath(const Key& key) {
+    QByteArray name = QCryptographicHash::hash(key.path.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return cacheDirectory() + "/" + QString::fromLatin1(name) + ".idx";
+}
+
+bool MetadataCache::load(const QString& fileName, Entry& entry) {
+    Key key;
+    if (!makeKey(fileName, key)) {
+        return false;
+    }
+
+    QFile file(entryPath(key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic, version;
+    in >> magic >> version;
+    if (magic != kMagic || version != kVersion) {
+        return false;
+    }
+
+    Key stored;
+    in >> stored.path >> stored.size >> stored.modified >> stored.fingerprint;
+    if (stored.path != key.path || stored.size != key.size || stored.modified != key.modified ||
+        stored.fingerprint != key.fingerprint) {
+        debug("vd", QString("Metadata cache entry for %1 is stale, ignoring it").arg(fileName));
+        file.close();
+        file.remove();
+        return false;
+    }
+
+    Entry loaded;
+    readMeta(in, loaded.meta);
+
+    qint32 streamIndex;
+    bool needsConversion;
+    qint64 startTime;
+    in >> streamIndex >> loaded.frameRate >> needsConversion >> startTime;
+    loaded.streamIndex = streamIndex;
+    loaded.needsTimebaseConversion = needsConversion;
+    loaded.startTime = startTime;
+
+    quint64 offsetCount;
+    in >> offsetCount;
+    if (in.status() != QDataStream::Ok || offsetCount > static_cast<quint64>(key.size)) {
+        return false;
+    }
+    loaded.y4mFrameOffsets.resize(offsetCount);
+    for (int64_t& offset : loaded.y4mFrameOffsets) {
+        qint64 value;
+        in >> value;
+        offset = value;
+    }
+
+    quint64 packetCount;
+    in >> packetCount;
+    if (in.status() != QDataStream::Ok || packetCount > static_cast<quint64>(key.size)) {
+        return false;
+    }
+    loaded.packets.resize(packetCount);
+    for (KeyframeIndex::Entry& packet : loaded.packets) {
+        qint64 pts, dts, pos;
+        bool keyframe;
+        in >> pts >> dts >> pos >> keyframe;
+        packet = {pts, dts, pos, keyframe};
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        warning("vd", QString("Metadata cache entry for %1 is corrupt, ignoring it").arg(fileName));
+        return false;
+    }
+
+    // Eviction drops the least recently used entries first, the owner may set the time through a read-only handle
+    file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+
+    entry = std::move(loaded);
+    debug("vd", QString("Loaded cached metadata for %1").arg(fileName));
+    return true;
+}
+
+void MetadataCache::store(const QString& fileName, const Entry& entry) {
+    Key key;
+    if (!makeKey(fileName, key)) {
+        return;
+    }
+
+    QMutexLocker locker(&s_writeMutex);
+
+    if (!QDir().mkpath(cacheDirectory())) {
+        warning("vd", QString("Cannot create metadata cache directory %1").arg(cacheDirectory()));
+        return;
+    }
+
+    QSaveFile file(entryPath(key));
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << kMagic << kVersion;
+    out << key.path << key.size << key.modified << key.fingerprint;
+    writeMeta(out, entry.meta);
+    out << qint32(entry.streamIndex) << entry.frameRate << entry.needsTimebaseConversion << qint64(entry.startTime);
+
+    out << quint64(entry.y4mFrameOffsets.size());
+    for (int64_t offset : entry.y4mFrameOffsets) {
+        out << qint64(offset);
+    }
+
+    out << quint64(entry.packets.size());
+    for (const KeyframeIndex::Entry& packet : entry.packets) {
+        out << qint64(packet.pts) << qint64(packet.dts) << qint64(packet.pos) << packet.keyframe;
+    }
+
+    if (!file.commit()) {
+        warning("vd", QString("Cannot write metadata cache entry for %1").arg(fileName));
+        return;
+    }
+
+    evict(kMaxCacheBytes);
+}
+
+void MetadataCache::evict(qint64 maxBytes) {
+    QDir dir(cacheDirectory());
+    QFileInfoList entries = dir.entryInfoList({"*.idx"}, QDir::Files, QDir::Time | QDir::Reversed);
+
+    qint64 total = 0;
+    for (const QFileInfo& info : entries) {
+        total += info.size();
+    }
+
+    // Oldest first thanks to the reversed time sort
+    for (const QFileInfo& info : entries) {
+        if (total <= maxBytes) {
+            break;
+        }
+        if (QFile::remove(info.absoluteFilePath())) {
+            total -= info.size();
+            debug("vd", QString("Evicted metadata cache entry %1").arg(info.fileName()));
+        }
+    }
+}
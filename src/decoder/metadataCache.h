@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <cstdint>
+#include <vector>
+
+#include "frames/frameMeta.h"
+#include "keyframeIndex.h"
+
+// Sidecar cache of probe results and seek indexes, one file per video under ~/.cache/yuviz.
+// Entries are keyed by path, size, modification time and a fingerprint of the file's first and
+// last bytes, so a changed file never hits a stale entry.
+class MetadataCache {
+  public:
+    struct Entry {
+        FrameMeta meta;
+        int streamIndex = -1;
+        double frameRate = 0.0;
+        bool needsTimebaseConversion = false;
+        int64_t startTime = INT64_MIN; // First presentation timestamp, INT64_MIN (AV_NOPTS_VALUE) when unknown
+        std::vector<int64_t> y4mFrameOffsets;
+        std::vector<KeyframeIndex::Entry> packets;
+    };
+
+    // Fills entry when a valid cache file exists for the current contents of fileName
+    static bool load(const QString& fileName, Entry& entry);
+
+    // Writes or replaces the entry of fileName, then evicts the oldest entries over the size limit.
+    // Safe to call from any thread.
+    static void store(const QString& fileName, const Entry& entry);
+
+    static QString cacheDirectory();
+
+  private:
+    struct Key {
+        QString path;
+        qint64 size = -1;
+        qint64 modified = -1;
+        QByteArray fingerprint;
+    };
+
+    static bool makeKey(const QString& fileName, Key& key);
+    static QString entryPath(const Key& key);
+    static void evict(qint64 maxBytes);
+};
@@ -0,0 +1,157 @@
+#include "packetQueue.h"
+#include <QString>
+#include "utils/debugManager.h"
+
+PacketQueue::~PacketQueue() {
+    stop();
+    for (AVPacket* packet : m_spare) {
+        av_packet_free(&packet);
+    }
+}
+
+void PacketQueue::start(AVFormatContext* formatContext, int streamIndex) {
+    stop();
+    if (!formatContext || streamIndex < 0) {
+        return;
+    }
+
+    m_formatContext = formatContext;
+    m_streamIndex = streamIndex;
+
+    // Only one stream is ever decoded, let the demuxer skip the others
+    for (unsigned int i = 0; i < m_formatContext->nb_streams; ++i) {
+        if (static_cast<int>(i) != m_streamIndex) {
+            m_formatContext->streams[i]->discard = AVDISCARD_ALL;
+        }
+    }
+
+    // Lets stop() abort a read stuck on slow storage instead of waiting it out
+    m_formatContext->interrupt_callback = {&PacketQueue::interruptRead, this};
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = true;
+    }
+    m_thread = std::thread(&PacketQueue::run, this);
+}
+
+void PacketQueue::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop.store(true, std::memory_order_release);
+    }
+    m_notFull.notify_all();
+    m_notEmpty.notify_all();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (AVPacket* packet : m_packets) {
+        av_packet_unref(packet);
+        m_spare.push_back(packet);
+    }
+    m_packets.clear();
+    m_bytes = 0;
+    m_status = 0;
+    m_running = false;
+    m_stop.store(false, std::memory_order_release);
+
+    if (m_formatContext) {
+        m_formatContext->interrupt_callback = {nullptr, nullptr};
+        m_formatContext = nullptr;
+    }
+}
+
+int PacketQueue::pop(AVPacket* packet) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_packets.empty() && m_running && m_status == 0) {
+        debug("vd", "Packet queue ran dry, waiting on the demuxer");
+        m_notEmpty.wait(lock, [this]() { return !m_packets.empty() || m_status != 0 || !m_running; });
+    }
+
+    if (m_packets.empty()) {
+        return m_status != 0 ? m_status : AVERROR_EOF;
+    }
+
+    AVPacket* queued = m_packets.front();
+    m_packets.pop_front();
+    m_bytes -= queued->size;
+    av_packet_move_ref(packet, queued);
+    m_spare.push_back(queued);
+    lock.unlock();
+
+    m_notFull.notify_one();
+    return 0;
+}
+
+void PacketQueue::run() {
+    while (true) {
+        AVPacket* packet = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notFull.wait(lock, [this]() { return m_stop.load(std::memory_order_acquire) || !isFull(); });
+            if (m_stop.load(std::memory_order_acquire)) {
+                return;
+            }
+            if (!m_spare.empty()) {
+                packet = m_spare.back();
+                m_spare.pop_back();
+            }
+        }
+
+        if (!packet && !(packet = av_packet_alloc())) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_status = AVERROR(ENOMEM);
+            m_notEmpty.notify_all();
+            return;
+        }
+
+        // The read itself runs unlocked so the decoder keeps draining the queue meanwhile
+        int ret = av_read_frame(m_formatContext, packet);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (ret < 0) {
+            m_spare.push_back(packet);
+            if (!m_stop.load(std::memory_order_acquire)) {
+                m_status = ret;
+            }
+            m_notEmpty.notify_all();
+            return;
+        }
+
+        if (packet->stream_index != m_streamIndex) {
+            av_packet_unref(packet);
+            m_spare.push_back(packet);
+            continue;
+        }
+
+        m_bytes += packet->size;
+        m_packets.push_back(packet);
+        m_notEmpty.notify_one();
+    }
+}
+
+bool PacketQueue::isFull() const {
+    if (m_packets.empty()) {
+        return false;
+    }
+    if (m_bytes >= m_limits.maxBytes) {
+        return true;
+    }
+
+    // Buffered duration is the decode time span between the oldest and newest packet
+    auto timestamp = [](const AVPacket* packet) { return packet->dts != AV_NOPTS_VALUE ? packet->dts : packet->pts; };
+    int64_t first = timestamp(m_packets.front());
+    int64_t last = timestamp(m_packets.back());
+    if (first == AV_NOPTS_VALUE || last == AV_NOPTS_VALUE) {
+        return false;
+    }
+    AVRational timeBase = m_formatContext->streams[m_streamIndex]->time_base;
+    return (last - first) * av_q2d(timeBase) >= m_limits.maxSeconds;
+}
+
+int PacketQueue::interruptRead(void* opaque) {
+    return static_cast<PacketQueue*>(opaque)->m_stop.load(std::memory_order_acquire) ? 1 : 0;
+}
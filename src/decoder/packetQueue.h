@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+// Read-ahead stage between the demuxer and the decoder. A dedicated thread pulls the packets of one
+// stream into a queue bounded by bytes and by stream duration, so slow storage only stalls decoding
+// once everything buffered has been consumed.
+class PacketQueue {
+  public:
+    struct Limits {
+        int64_t maxBytes = 64LL * 1024 * 1024;
+        double maxSeconds = 10.0;
+    };
+
+    PacketQueue() = default;
+    ~PacketQueue();
+
+    // Takes effect on the next start()
+    void setLimits(const Limits& limits) { m_limits = limits; }
+
+    // Starts reading at the demuxer's current position. The format context belongs to the reader
+    // thread until stop() returns.
+    void start(AVFormatContext* formatContext, int streamIndex);
+
+    // Stops the reader, aborting a blocked read, and drops every queued packet
+    void stop();
+
+    // Moves the next packet into packet, blocking while the reader is behind.
+    // @return 0, AVERROR_EOF once the stream ended, or the error that stopped the reader
+    int pop(AVPacket* packet);
+
+  private:
+    void run();
+    bool isFull() const;
+    static int interruptRead(void* opaque);
+
+    AVFormatContext* m_formatContext = nullptr;
+    int m_streamIndex = -1;
+    Limits m_limits;
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+    std::deque<AVPacket*> m_packets;
+    // Emptied packets, reused so steady state reading allocates no AVPacket
+    std::vector<AVPacket*> m_spare;
+    int64_t m_bytes = 0;
+    int m_status = 0; // Set once the reader finished, AVERROR_EOF or a read error
+    bool m_running = false;
+    std::atomic<bool> m_stop = false;
+};
@@ -0,0 +1,120 @@
+#include "rawFrameReader.h"
+#include <algorithm>
+#include "utils/debugManager.h"
+#include "utils/errorReporter.h"
+
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+// Address space covered by one mapping window, always rounded to whole frames
+constexpr int64_t kWindowBytes = int64_t{1} << 30;
+} // namespace
+
+RawFrameReader::~RawFrameReader() {
+    close();
+}
+
+bool RawFrameReader::open(const QString& fileName, int64_t frameSize) {
+    close();
+
+    if (frameSize <= 0) {
+        ErrorReporter::instance().report("Invalid raw YUV frame size", LogLevel::Error);
+        return false;
+    }
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        ErrorReporter::instance().report("Could not open input file " + fileName.toStdString(), LogLevel::Error);
+        return false;
+    }
+
+    m_frameSize = frameSize;
+    m_frameCount = m_file.size() / frameSize;
+    m_framesPerWindow = std::max<int64_t>(1, kWindowBytes / frameSize);
+
+    debug("vd",
+          QString("Mapped raw YUV reader: %1 frames of %2 bytes, %3 frames per window")
+              .arg(m_frameCount)
+              .arg(m_frameSize)
+              .arg(m_framesPerWindow));
+    return true;
+}
+
+void RawFrameReader::close() {
+    if (m_window) {
+        m_file.unmap(m_window);
+        m_window = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+
+    m_windowFirst = 0;
+    m_windowFrames = 0;
+    m_frameCount = 0;
+}
+
+const uint8_t* RawFrameReader::frame(int64_t index) {
+    if (index < 0 || index >= m_frameCount) {
+        return nullptr;
+    }
+
+    if (!m_window || index < m_windowFirst || index >= m_windowFirst + m_windowFrames) {
+        if (!mapWindow(index)) {
+            return nullptr;
+        }
+    }
+
+    return m_window + (index - m_windowFirst) * m_frameSize;
+}
+
+bool RawFrameReader::mapWindow(int64_t index) {
+    if (m_window) {
+        m_file.unmap(m_window);
+        m_window = nullptr;
+    }
+
+    // Windows start on multiples of their length, so playback in either direction remaps rarely
+    int64_t first = (index / m_framesPerWindow) * m_framesPerWindow;
+    int64_t frames = std::min(m_framesPerWindow, m_frameCount - first);
+
+    m_window = m_file.map(first * m_frameSize, frames * m_frameSize);
+    if (!m_window) {
+        ErrorReporter::instance().report("Failed to map raw YUV file: " + m_file.errorString().toStdString(),
+                                         LogLevel::Error);
+        m_windowFrames = 0;
+        return false;
+    }
+
+    m_windowFirst = first;
+    m_windowFrames = frames;
+    debug("vd", QString("Mapped raw YUV frames %1 to %2").arg(first).arg(first + frames - 1));
+    return true;
+}
+
+void RawFrameReader::prefetch(int64_t firstIndex, int count) {
+#ifdef Q_OS_UNIX
+    if (!m_window) {
+        return;
+    }
+
+    int64_t begin = std::max(firstIndex, m_windowFirst);
+    int64_t end = std::min(firstIndex + count, m_windowFirst + m_windowFrames);
+    if (begin >= end) {
+        return;
+    }
+
+    // madvise wants a page aligned start, QFile::map() maps from the enclosing page boundary
+    static const uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    uintptr_t start = reinterpret_cast<uintptr_t>(m_window + (begin - m_windowFirst) * m_frameSize);
+    uintptr_t alignedStart = start & ~(pageSize - 1);
+    size_t length = static_cast<size_t>((end - begin) * m_frameSize) + (start - alignedStart);
+    posix_madvise(reinterpret_cast<void*>(alignedStart), length, POSIX_MADV_WILLNEED);
+#else
+    Q_UNUSED(firstIndex);
+    Q_UNUSED(count);
+#endif
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <cstdint>
+
+// Serves fixed-size frames of a raw YUV file straight from a memory mapping.
+// Huge captures are mapped through a sliding window so the address space use stays bounded.
+class RawFrameReader {
+  public:
+    RawFrameReader() = default;
+    ~RawFrameReader();
+
+    bool open(const QString& fileName, int64_t frameSize);
+    void close();
+
+    bool isOpen() const { return m_file.isOpen(); }
+    int64_t frameCount() const { return m_frameCount; }
+    int64_t frameSize() const { return m_frameSize; }
+
+    // Returns the frame data, valid until the next call to frame() or close()
+    const uint8_t* frame(int64_t index);
+
+    // Asks the kernel to start reading the given frames into the page cache
+    void prefetch(int64_t firstIndex, int count);
+
+  private:
+    bool mapWindow(int64_t index);
+
+    QFile m_file;
+    int64_t m_frameSize = 0;
+    int64_t m_frameCount = 0;
+
+    uchar* m_window = nullptr;
+    int64_t m_windowFirst = 0;
+    int64_t m_windowFrames = 0;
+    int64_t m_framesPerWindow = 0;
+};
@@ -0,0 +1,260 @@
+#include "streamFrameReader.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "utils/debugManager.h"
+#include "utils/errorReporter.h"
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef Q_OS_WIN
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace {
+constexpr char kY4MMagic[] = "YUV4MPEG2";
+constexpr int64_t kY4MMagicSize = sizeof(kY4MMagic) - 1;
+// Longest header line accepted before the stream is considered garbage
+constexpr int kMaxHeaderLine = 4096;
+// How often a waiting read checks whether it was interrupted
+constexpr int kPollIntervalMs = 100;
+} // namespace
+
+StreamFrameReader::~StreamFrameReader() {
+    close();
+}
+
+bool StreamFrameReader::isStreamPath(const QString& path) {
+    if (path == QLatin1String("-")) {
+        return true;
+    }
+#ifdef Q_OS_UNIX
+    struct stat info;
+    return ::stat(path.toLocal8Bit().constData(), &info) == 0 && S_ISFIFO(info.st_mode);
+#else
+    return false;
+#endif
+}
+
+bool StreamFrameReader::open(const QString& path, int64_t rawFrameSize, int historyFrames) {
+    close();
+    m_interrupted = false;
+
+    bool isStdin = path == QLatin1String("-");
+#ifdef Q_OS_UNIX
+    // Opening a named pipe blocks until the producer opens its end
+    m_fd = isStdin ? STDIN_FILENO : ::open(path.toLocal8Bit().constData(), O_RDONLY | O_CLOEXEC);
+    m_open = m_fd >= 0;
+#else
+    if (isStdin) {
+#ifdef Q_OS_WIN
+        // Frames are binary, stdin must not translate line endings
+        _setmode(_fileno(stdin), _O_BINARY);
+#endif
+        m_open = m_file.open(stdin, QIODevice::ReadOnly | QIODevice::Unbuffered);
+    } else {
+        m_file.setFileName(path);
+        m_open = m_file.open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    }
+#endif
+    if (!m_open) {
+        ErrorReporter::instance().report("Could not open input stream " + path.toStdString(), LogLevel::Error);
+        return false;
+    }
+
+    // The first bytes tell Y4M from raw, for raw streams they already belong to frame 0
+    uint8_t magic[kY4MMagicSize];
+    int64_t magicBytes = 0;
+    while (magicBytes < kY4MMagicSize) {
+        int64_t n = readSome(magic + magicBytes, kY4MMagicSize - magicBytes);
+        if (n <= 0) {
+            break;
+        }
+        magicBytes += n;
+    }
+
+    if (magicBytes == kY4MMagicSize && memcmp(magic, kY4MMagic, kY4MMagicSize) == 0) {
+        QByteArray headerLine(kY4MMagic);
+        char c = 0;
+        while (headerLine.size() < kMaxHeaderLine && readSome(reinterpret_cast<uint8_t*>(&c), 1) == 1 && c != '\n') {
+            headerLine.append(c);
+        }
+        m_y4mInfo = Y4MParser::parseHeaderLine(headerLine);
+        if (!m_y4mInfo.isValid) {
+            close();
+            return false;
+        }
+        m_frameSize = Y4MParser::calculateFrameSize(m_y4mInfo);
+        magicBytes = 0;
+    } else {
+        if (rawFrameSize <= 0) {
+            ErrorReporter::instance().report("Raw input streams need a resolution and pixel format", LogLevel::Error);
+            close();
+            return false;
+        }
+        m_frameSize = rawFrameSize;
+    }
+
+    // The peeked bytes may cover more than one tiny raw frame, the history has to hold all of them
+    m_historyFrames = std::max<int64_t>(historyFrames, kY4MMagicSize / m_frameSize + 1);
+    m_history.resize(static_cast<size_t>(m_historyFrames * m_frameSize));
+    if (magicBytes > 0) {
+        memcpy(m_history.data(), magic, static_cast<size_t>(magicBytes));
+        m_framesRead = magicBytes / m_frameSize;
+        m_partialBytes = magicBytes % m_frameSize;
+    }
+
+    debug("vd",
+          QString("Streaming %1 frames of %2 bytes from %3, keeping %4 frames of history")
+              .arg(isY4M() ? "Y4M" : "raw")
+              .arg(m_frameSize)
+              .arg(isStdin ? QStringLiteral("stdin") : path)
+              .arg(m_historyFrames));
+    return true;
+}
+
+void StreamFrameReader::close() {
+#ifdef Q_OS_UNIX
+    if (m_fd >= 0 && m_fd != STDIN_FILENO) {
+        ::close(m_fd);
+    }
+    m_fd = -1;
+#endif
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+
+    m_open = false;
+    m_ended = false;
+    m_y4mInfo = Y4MInfo();
+    m_frameSize = 0;
+    std::vector<uint8_t>().swap(m_history);
+    m_historyFrames = 0;
+    m_framesRead = 0;
+    m_partialBytes = 0;
+    m_headerDone = false;
+    m_headerLine.clear();
+}
+
+void StreamFrameReader::interrupt() {
+    m_interrupted.store(true, std::memory_order_relaxed);
+}
+
+bool StreamFrameReader::waitReadable(bool wait) {
+#ifdef Q_OS_UNIX
+    pollfd pfd{m_fd, POLLIN, 0};
+    while (!m_interrupted.load(std::memory_order_relaxed)) {
+        int ret = ::poll(&pfd, 1, wait ? kPollIntervalMs : 0);
+        // A hang up or error is readable too, read() then reports the end of the stream
+        if (ret > 0 || (ret < 0 && errno != EINTR)) {
+            return true;
+        }
+        if (ret == 0 && !wait) {
+            return false;
+        }
+    }
+    return false;
+#else
+    // Pipes cannot be polled here, reads simply block
+    Q_UNUSED(wait);
+    return !m_interrupted.load(std::memory_order_relaxed);
+#endif
+}
+
+int64_t StreamFrameReader::readSome(uint8_t* dst, int64_t size) {
+#ifdef Q_OS_UNIX
+    ssize_t n;
+    do {
+        n = ::read(m_fd, dst, static_cast<size_t>(size));
+    } while (n < 0 && errno == EINTR);
+    return n;
+#else
+    return m_file.read(reinterpret_cast<char*>(dst), size);
+#endif
+}
+
+bool StreamFrameReader::readFrameHeader(bool wait) {
+    while (!m_headerDone) {
+        if (!waitReadable(wait)) {
+            return false;
+        }
+        char c = 0;
+        if (readSome(reinterpret_cast<uint8_t*>(&c), 1) != 1) {
+            m_ended = true;
+            return false;
+        }
+        if (c != '\n') {
+            m_headerLine.append(c);
+            if (m_headerLine.size() > kMaxHeaderLine) {
+                warning("vd", "Y4M stream frame header too long, stopping the stream");
+                m_ended = true;
+                return false;
+            }
+            continue;
+        }
+        if (!m_headerLine.startsWith("FRAME")) {
+            warning("vd", QString("Y4M stream lost frame sync after frame %1").arg(m_framesRead));
+            m_ended = true;
+            return false;
+        }
+        m_headerLine.clear();
+        m_headerDone = true;
+    }
+    return true;
+}
+
+bool StreamFrameReader::readNextFrame(bool wait) {
+    if (m_ended) {
+        return false;
+    }
+    if (isY4M() && !readFrameHeader(wait)) {
+        m_ended = m_ended || m_interrupted.load(std::memory_order_relaxed);
+        return false;
+    }
+
+    uint8_t* dst = slot(m_framesRead);
+    while (m_partialBytes < m_frameSize) {
+        if (!waitReadable(wait)) {
+            m_ended = m_interrupted.load(std::memory_order_relaxed);
+            return false;
+        }
+        int64_t n = readSome(dst + m_partialBytes, m_frameSize - m_partialBytes);
+        if (n <= 0) {
+            // A truncated trailing frame is dropped like in files
+            debug("vd", QString("Input stream ended after %1 frames").arg(m_framesRead));
+            m_ended = true;
+            return false;
+        }
+        m_partialBytes += n;
+    }
+
+    m_partialBytes = 0;
+    m_headerDone = false;
+    ++m_framesRead;
+    return true;
+}
+
+const uint8_t* StreamFrameReader::frame(int64_t index, bool wait) {
+    if (!m_open || index < 0) {
+        return nullptr;
+    }
+    if (index < m_framesRead - m_historyFrames) {
+        warning("vd", QString("Frame %1 is no longer in the stream history").arg(index));
+        return nullptr;
+    }
+
+    // Frames before the requested one are read into the history on the way
+    while (m_framesRead <= index) {
+        if (!readNextFrame(wait)) {
+            return nullptr;
+        }
+    }
+    return slot(index);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "utils/y4mParser.h"
+
+// Reads raw YUV or Y4M frames sequentially from stdin ("-") or a named pipe. The stream cannot
+// seek, so the most recent frames are kept in a bounded rolling history for stepping backward.
+// Frames are only pulled from the pipe when they are asked for, a paused viewer holds the
+// producer back instead of dropping frames.
+class StreamFrameReader {
+  public:
+    StreamFrameReader() = default;
+    ~StreamFrameReader();
+
+    StreamFrameReader(const StreamFrameReader&) = delete;
+    StreamFrameReader& operator=(const StreamFrameReader&) = delete;
+
+    // True for "-" and for named pipes
+    static bool isStreamPath(const QString& path);
+
+    // Blocks until the stream delivers its first bytes. Streams starting with a Y4M header are read
+    // as Y4M, anything else as raw frames of rawFrameSize bytes.
+    bool open(const QString& path, int64_t rawFrameSize, int historyFrames);
+    void close();
+
+    bool isOpen() const { return m_open; }
+    bool isY4M() const { return m_y4mInfo.isValid; }
+    const Y4MInfo& y4mInfo() const { return m_y4mInfo; }
+    int64_t frameSize() const { return m_frameSize; }
+
+    // Frames received so far, the stream is live until it ends
+    int64_t framesRead() const { return m_framesRead; }
+    bool atEnd() const { return m_ended; }
+
+    // Returns the frame data, valid until the next call to frame() or close(). Without wait only
+    // data already in the pipe is read. nullptr when the frame has not arrived yet, the stream
+    // ended before it or it dropped out of the history.
+    const uint8_t* frame(int64_t index, bool wait);
+
+    // Unblocks a waiting frame() from another thread, the stream counts as ended afterwards
+    void interrupt();
+
+  private:
+    bool waitReadable(bool wait);
+    int64_t readSome(uint8_t* dst, int64_t size);
+    bool readFrameHeader(bool wait);
+    bool readNextFrame(bool wait);
+    uint8_t* slot(int64_t index) { return m_history.data() + (index % m_historyFrames) * m_frameSize; }
+
+    QFile m_file;
+    int m_fd = -1;
+    bool m_open = false;
+    bool m_ended = false;
+    std::atomic<bool> m_interrupted = false;
+
+    Y4MInfo m_y4mInfo;
+    int64_t m_frameSize = 0;
+
+    std::vector<uint8_t> m_history;
+    int64_t m_historyFrames = 0;
+    int64_t m_framesRead = 0;
+
+    // Progress through the frame being read, kept across calls that return before it completes
+    int64_t m_partialBytes = 0;
+    bool m_headerDone = false;
+    QByteArray m_headerLine;
+};
@@ -0,0 +1,338 @@
+#include "thumbnailEngine.h"
+#include <QThread>
+#include <algorithm>
+#include <cstring>
+#include "utils/debugManager.h"
+#include "utils/videoFormatUtils.h"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/pixdesc.h>
+#include <libswscale/swscale.h>
+}
+
+namespace {
+constexpr int kMaxTiles = 100;
+constexpr int kTileHeight = 72;
+// Bounds the packets fed while looking for one keyframe, so broken streams cannot stall a build
+constexpr int kMaxPacketsPerTile = 256;
+constexpr int kPublishEvery = 8;
+
+struct DecodeContext {
+    AVFormatContext* format = nullptr;
+    AVCodecContext* codec = nullptr;
+    SwsContext* sws = nullptr;
+    AVPacket* packet = nullptr;
+    AVFrame* frame = nullptr;
+
+    ~DecodeContext() {
+        sws_freeContext(sws);
+        av_frame_free(&frame);
+        av_packet_free(&packet);
+        avcodec_free_context(&codec);
+        avformat_close_input(&format);
+    }
+};
+
+/**
+ * @brief Decodes the first keyframe after the demuxer position into ctx.frame
+ * @param keyframePts Keyframe decoded for the previous tile, updated to the new one
+ * @return 1 for a new frame, 0 when the seek landed on the previous keyframe again, <0 on error
+ */
+int decodeKeyframe(DecodeContext& ctx, int streamIndex, int64_t& keyframePts) {
+    int packets = 0;
+    bool draining = false;
+    while (true) {
+        int ret = avcodec_receive_frame(ctx.codec, ctx.frame);
+        if (ret != AVERROR(EAGAIN)) {
+            return ret == 0 ? 1 : ret;
+        }
+
+        if (draining) {
+            return AVERROR_EOF;
+        }
+        if (packets >= kMaxPacketsPerTile || av_read_frame(ctx.format, ctx.packet) < 0) {
+            // Decoders with reordering delay only give up the keyframe once flushed
+            avcodec_send_packet(ctx.codec, nullptr);
+            draining = true;
+            continue;
+        }
+
+        if (ctx.packet->stream_index == streamIndex) {
+            if ((ctx.packet->flags & AV_PKT_FLAG_KEY) && ctx.packet->pts != AV_NOPTS_VALUE) {
+                if (packets == 0 && ctx.packet->pts == keyframePts) {
+                    av_packet_unref(ctx.packet);
+                    return 0;
+                }
+                if (packets == 0) {
+                    keyframePts = ctx.packet->pts;
+                }
+            }
+            avcodec_send_packet(ctx.codec, ctx.packet);
+            ++packets;
+        }
+        av_packet_unref(ctx.packet);
+    }
+}
+} // namespace
+
+ThumbnailEngine::ThumbnailEngine(QObject* parent) :
+    QObject(parent) {
+    // One build at a time, below the playback threads
+    m_pool.setMaxThreadCount(1);
+    m_pool.setThreadPriority(QThread::LowestPriority);
+}
+
+ThumbnailEngine::~ThumbnailEngine() {
+    {
+        QMutexLocker lock(&m_mutex);
+        for (auto& [index, strip] : m_strips) {
+            strip.cancelled->store(true);
+        }
+    }
+    m_pool.waitForDone();
+}
+
+void ThumbnailEngine::addVideo(int index, const VideoFileInfo& info, int totalFrames) {
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    {
+        QMutexLocker lock(&m_mutex);
+        Strip& strip = m_strips[index];
+        strip.cancelled = cancelled;
+        strip.totalFrames = totalFrames;
+    }
+
+    debug("tn", QString("Queued thumbnails for video %1").arg(index));
+    m_pool.start([this, index, info, totalFrames, cancelled]() { build(index, info, totalFrames, cancelled); });
+}
+
+void ThumbnailEngine::removeVideo(int index) {
+    {
+        QMutexLocker lock(&m_mutex);
+        auto it = m_strips.find(index);
+        if (it == m_strips.end()) {
+            return;
+        }
+        it->second.cancelled->store(true);
+        m_strips.erase(it);
+    }
+
+    debug("tn", QString("Dropped thumbnails of video %1").arg(index));
+    m_revision.fetch_add(1, std::memory_order_relaxed);
+    emit thumbnailsChanged();
+}
+
+void ThumbnailEngine::setPlaybackLoad(bool playing, bool buffering) {
+    m_playing.store(playing, std::memory_order_relaxed);
+    m_buffering.store(buffering, std::memory_order_relaxed);
+}
+
+int ThumbnailEngine::primaryVideo() const {
+    QMutexLocker lock(&m_mutex);
+    for (const auto& [index, strip] : m_strips) {
+        if (!strip.tileFrames.empty()) {
+            return index;
+        }
+    }
+    return -1;
+}
+
+int ThumbnailEngine::tileCount() const {
+    int index = primaryVideo();
+    QMutexLocker lock(&m_mutex);
+    auto it = m_strips.find(index);
+    return it != m_strips.end() ? static_cast<int>(it->second.tileFrames.size()) : 0;
+}
+
+QImage ThumbnailEngine::thumbnail(int index, int64_t frame) const {
+    QMutexLocker lock(&m_mutex);
+    auto it = m_strips.find(index);
+    if (it == m_strips.end() || it->second.atlas.isNull() || it->second.totalFrames <= 0) {
+        return {};
+    }
+
+    const Strip& strip = it->second;
+    int count = static_cast<int>(strip.tileFrames.size());
+    int tile = static_cast<int>(std::clamp<int64_t>(frame * count / strip.totalFrames, 0, count - 1));
+    if (strip.tileFrames[tile] < 0) {
+        return {};
+    }
+    return strip.atlas.copy(tile * strip.tileWidth, 0, strip.tileWidth, strip.tileHeight);
+}
+
+void ThumbnailEngine::build(int index,
+                            VideoFileInfo info,
+                            int totalFrames,
+                            std::shared_ptr<std::atomic<bool>> cancelled) {
+    if (cancelled->load()) {
+        return;
+    }
+
+    // Raw files carry no header, describe them to the rawvideo demuxer the way the user did
+    const AVInputFormat* inputFormat = nullptr;
+    AVDictionary* options = nullptr;
+    QString formatIdentifier = VideoFormatUtils::detectFormatFromExtension(info.filename);
+    if (VideoFormatUtils::getFormatType(formatIdentifier) == FormatType::RAW_YUV) {
+        inputFormat = av_find_input_format("rawvideo");
+        av_dict_set(&options, "video_size", qPrintable(QString("%1x%2").arg(info.width).arg(info.height)), 0);
+        av_dict_set(&options, "pixel_format", av_get_pix_fmt_name(info.pixelFormat), 0);
+        av_dict_set(&options, "framerate", qPrintable(QString::number(info.framerate)), 0);
+    }
+
+    DecodeContext ctx;
+    ctx.format = avformat_alloc_context();
+    if (!ctx.format) {
+        av_dict_free(&options);
+        return;
+    }
+    // Lets removeVideo() abort a read stuck on slow storage
+    ctx.format->interrupt_callback = {&ThumbnailEngine::interruptRead, cancelled.get()};
+
+    int ret = avformat_open_input(&ctx.format, info.filename.toUtf8().constData(), inputFormat, &options);
+    av_dict_free(&options);
+    if (ret < 0 || avformat_find_stream_info(ctx.format, nullptr) < 0) {
+        warning("tn", QString("Cannot open %1 for thumbnails").arg(info.filename));
+        return;
+    }
+
+    const AVCodec* codec = nullptr;
+    int streamIndex = av_find_best_stream(ctx.format, AVMEDIA_TYPE_VIDEO, -1, -1, &codec, 0);
+    if (streamIndex < 0 || !codec) {
+        return;
+    }
+    AVStream* stream = ctx.format->streams[streamIndex];
+
+    ctx.codec = avcodec_alloc_context3(codec);
+    ctx.packet = av_packet_alloc();
+    ctx.frame = av_frame_alloc();
+    if (!ctx.codec || !ctx.packet || !ctx.frame || avcodec_parameters_to_context(ctx.codec, stream->codecpar) < 0) {
+        return;
+    }
+    // A single slow thread keeps the cores free for playback, only keyframes are ever wanted
+    ctx.codec->thread_count = 1;
+    ctx.codec->skip_frame = AVDISCARD_NONKEY;
+    if (avcodec_open2(ctx.codec, codec, nullptr) < 0 || ctx.codec->width <= 0 || ctx.codec->height <= 0) {
+        return;
+    }
+
+    AVRational frameRate = stream->avg_frame_rate.num > 0 ? stream->avg_frame_rate : av_d2q(info.framerate, 1000000);
+    int64_t startTime = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+    if (totalFrames <= 0) {
+        totalFrames = static_cast<int>(stream->nb_frames);
+    }
+    if (totalFrames <= 0 || frameRate.num <= 0) {
+        return;
+    }
+
+    double sampleAspect = stream->codecpar->sample_aspect_ratio.num > 0 ? av_q2d(stream->codecpar->sample_aspect_ratio)
+                                                                        : 1.0;
+    int tileCount = std::min(totalFrames, kMaxTiles);
+    int tileHeight = kTileHeight;
+    int tileWidth = std::max(1, static_cast<int>(kTileHeight * sampleAspect * ctx.codec->width / ctx.codec->height));
+    if (!initStrip(index, tileWidth, tileHeight, tileCount, totalFrames)) {
+        return;
+    }
+
+    QImage tile(tileWidth, tileHeight, QImage::Format_RGBA8888);
+    int64_t keyframePts = AV_NOPTS_VALUE;
+    int64_t tileFrame = -1;
+    for (int i = 0; i < tileCount && waitForIdle(*cancelled); ++i) {
+        int64_t target = static_cast<int64_t>(i) * totalFrames / tileCount;
+        int64_t timestamp = startTime + av_rescale_q(target, av_inv_q(frameRate), stream->time_base);
+        if (av_seek_frame(ctx.format, streamIndex, timestamp, AVSEEK_FLAG_BACKWARD) < 0) {
+            continue;
+        }
+        avcodec_flush_buffers(ctx.codec);
+
+        ret = decodeKeyframe(ctx, streamIndex, keyframePts);
+        if (ret < 0) {
+            continue;
+        }
+        if (ret > 0) {
+            int64_t pts = ctx.frame->best_effort_timestamp;
+            tileFrame = pts != AV_NOPTS_VALUE ? av_rescale_q(pts - startTime, stream->time_base, av_inv_q(frameRate))
+                                              : target;
+
+            // Area averaging is a box filter, cheap and alias free at these ratios
+            ctx.sws = sws_getCachedContext(ctx.sws,
+                                           ctx.frame->width,
+                                           ctx.frame->height,
+                                           static_cast<AVPixelFormat>(ctx.frame->format),
+                                           tileWidth,
+                                           tileHeight,
+                                           AV_PIX_FMT_RGBA,
+                                           SWS_AREA,
+                                           nullptr,
+                                           nullptr,
+                                           nullptr);
+            if (!ctx.sws) {
+                av_frame_unref(ctx.frame);
+                break;
+            }
+            uint8_t* dst[4] = {tile.bits(), nullptr, nullptr, nullptr};
+            int dstStride[4] = {static_cast<int>(tile.bytesPerLine()), 0, 0, 0};
+            sws_scale(ctx.sws, ctx.frame->data, ctx.frame->linesize, 0, ctx.frame->height, dst, dstStride);
+            av_frame_unref(ctx.frame);
+        }
+
+        // A repeated keyframe shows the previous tile again
+        storeTile(index, i, tileFrame, tile);
+        if ((i + 1) % kPublishEvery == 0 || i + 1 == tileCount) {
+            m_revision.fetch_add(1, std::memory_order_relaxed);
+            emit thumbnailsChanged();
+        }
+    }
+
+    debug("tn", QString("Thumbnails for video %1 %2").arg(index).arg(cancelled->load() ? "cancelled" : "done"));
+}
+
+bool ThumbnailEngine::initStrip(int index, int tileWidth, int tileHeight, int tileCount, int totalFrames) {
+    {
+        QMutexLocker lock(&m_mutex);
+        auto it = m_strips.find(index);
+        if (it == m_strips.end()) {
+            return false;
+        }
+        Strip& strip = it->second;
+        strip.atlas = QImage(tileWidth * tileCount, tileHeight, QImage::Format_RGBA8888);
+        strip.atlas.fill(Qt::black);
+        strip.tileWidth = tileWidth;
+        strip.tileHeight = tileHeight;
+        strip.totalFrames = totalFrames;
+        strip.tileFrames.assign(tileCount, -1);
+    }
+
+    m_revision.fetch_add(1, std::memory_order_relaxed);
+    emit thumbnailsChanged();
+    return true;
+}
+
+void ThumbnailEngine::storeTile(int index, int tile, int64_t frame, const QImage& image) {
+    QMutexLocker lock(&m_mutex);
+    auto it = m_strips.find(index);
+    if (it == m_strips.end() || tile >= static_cast<int>(it->second.tileFrames.size())) {
+        return;
+    }
+
+    Strip& strip = it->second;
+    size_t rowBytes = static_cast<size_t>(strip.tileWidth) * 4;
+    for (int y = 0; y < strip.tileHeight; ++y) {
+        memcpy(strip.atlas.scanLine(y) + tile * rowBytes, image.constScanLine(y), rowBytes);
+    }
+    strip.tileFrames[tile] = frame;
+}
+
+bool ThumbnailEngine::waitForIdle(const std::atomic<bool>& cancelled) const {
+    // Playback decoders come first: stop while one of them is stalled, leave gaps while playing
+    while (!cancelled.load() && m_buffering.load(std::memory_order_relaxed)) {
+        QThread::msleep(100);
+    }
+    if (!cancelled.load() && m_playing.load(std::memory_order_relaxed)) {
+        QThread::msleep(40);
+    }
+    return !cancelled.load();
+}
+
+int ThumbnailEngine::interruptRead(void* opaque) {
+    return static_cast<std::atomic<bool>*>(opaque)->load() ? 1 : 0;
+}
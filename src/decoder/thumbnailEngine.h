@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QImage>
+#include <QMutex>
+#include <QObject>
+#include <QThreadPool>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+#include "utils/videoFileInfo.h"
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+// Builds a filmstrip of small thumbnails for every loaded video on a low priority background
+// thread. Compressed files are sampled at keyframes, raw YUV and Y4M files every Nth frame. The
+// engine runs its own demuxer and decoder, playback decoders and frame queues are never touched.
+class ThumbnailEngine : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(int primaryVideo READ primaryVideo NOTIFY thumbnailsChanged)
+    Q_PROPERTY(int tileCount READ tileCount NOTIFY thumbnailsChanged)
+    Q_PROPERTY(int revision READ revision NOTIFY thumbnailsChanged)
+
+  public:
+    explicit ThumbnailEngine(QObject* parent = nullptr);
+    ~ThumbnailEngine();
+
+    void addVideo(int index, const VideoFileInfo& info, int totalFrames);
+
+    // Cancels a build still running, the thumbnails of the video are dropped right away
+    void removeVideo(int index);
+
+    // Builds slow down while playing and pause while a playback decoder is stalled
+    void setPlaybackLoad(bool playing, bool buffering);
+
+    // Lowest video index with a filmstrip, -1 when there is none
+    int primaryVideo() const;
+    int tileCount() const;
+    // Bumped whenever tiles arrive so QML reloads its images
+    int revision() const { return m_revision.load(std::memory_order_relaxed); }
+
+    // Tile covering the given frame, a null image until it is decoded
+    QImage thumbnail(int index, int64_t frame) const;
+
+  signals:
+    void thumbnailsChanged();
+
+  private:
+    struct Strip {
+        QImage atlas;
+        int tileWidth = 0;
+        int tileHeight = 0;
+        int totalFrames = 0;
+        std::vector<int64_t> tileFrames; // Frame shown by each tile, -1 until decoded
+        std::shared_ptr<std::atomic<bool>> cancelled;
+    };
+
+    void build(int index, VideoFileInfo info, int totalFrames, std::shared_ptr<std::atomic<bool>> cancelled);
+    bool initStrip(int index, int tileWidth, int tileHeight, int tileCount, int totalFrames);
+    void storeTile(int index, int tile, int64_t frame, const QImage& image);
+    bool waitForIdle(const std::atomic<bool>& cancelled) const;
+    static int interruptRead(void* opaque);
+
+    mutable QMutex m_mutex;
+    std::map<int, Strip> m_strips;
+    QThreadPool m_pool;
+
+    std::atomic<int> m_revision = 0;
+    std::atomic<bool> m_playing = false;
+    std::atomic<bool> m_buffering = false;
+};
@@ -1,10 +1,62 @@
 #include "videoDecoder.h"
 #include <QFile>
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
 #include <thread>
+#include "utils/allocationCounter.h"
+#include "utils/appConfig.h"
 #include "utils/debugManager.h"
+#include "utils/pixelKernels.h"
 #include "utils/videoFormatUtils.h"
 
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+
+namespace {
+// Returned by loadCompressedFrame() for a frame that decoded but could not be written to its slot
+constexpr int64_t kFrameFailed = -2;
+
+// Planar 8 bit YUV is stored in the slot as decoded, everything else is converted to 4:2:0
+AVPixelFormat slotFormat(AVPixelFormat decoded) {
+    const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(decoded);
+    if (!desc || desc->nb_components != 3 || !(desc->flags & AV_PIX_FMT_FLAG_PLANAR) ||
+        (desc->flags & (AV_PIX_FMT_FLAG_RGB | AV_PIX_FMT_FLAG_HWACCEL)) || desc->comp[0].depth != 8 ||
+        desc->comp[1].plane != 1 || desc->comp[2].plane != 2) {
+        return AV_PIX_FMT_YUV420P;
+    }
+    return decoded;
+}
+
+// Pixel memory a decoded frame holds on to
+int64_t frameBytes(const AVFrame* frame) {
+    int64_t bytes = 0;
+    for (const AVBufferRef* buffer : frame->buf) {
+        if (buffer) {
+            bytes += static_cast<int64_t>(buffer->size);
+        }
+    }
+    return bytes;
+}
+
+// Spreads a frame stored with unpadded rows and its planes back to back over the padded rows of a slot
+void copyToSlot(const uint8_t* src, FrameData* frameData, const FrameMeta& meta) {
+    int yRow = meta.yRowBytes();
+    av_image_copy_plane(frameData->yPtr(), frameData->yStride(), src, yRow, yRow, meta.yHeight());
+    int uvRow = meta.uvRowBytes();
+    if (uvRow == 0) {
+        return;
+    }
+    src += static_cast<size_t>(yRow) * meta.yHeight();
+    av_image_copy_plane(frameData->uPtr(), frameData->uvStride(), src, uvRow, uvRow, meta.uvHeight());
+    if (!meta.isSemiPlanar()) {
+        src += static_cast<size_t>(uvRow) * meta.uvHeight();
+        av_image_copy_plane(frameData->vPtr(), frameData->uvStride(), src, uvRow, uvRow, meta.uvHeight());
+    }
+}
+} // namespace
+
 VideoDecoder::VideoDecoder(QObject* parent) :
     QObject(parent),
     formatContext(nullptr),
@@ -49,6 +101,26 @@ void VideoDecoder::setFrameQueue(std::shared_ptr<FrameQueue> frameQueue) {
     m_frameQueue = frameQueue;
 }
 
+void VideoDecoder::setDecodeThreads(int threads) {
+    m_decodeThreads = threads;
+}
+
+void VideoDecoder::setGpuUnpack(bool enabled) {
+    m_gpuUnpack = enabled;
+}
+
+void VideoDecoder::setProxyShift(int shift) {
+    m_proxyShift.store(shift, std::memory_order_relaxed);
+}
+
+void VideoDecoder::setStreamHistory(int frames) {
+    m_streamHistory = frames;
+}
+
+void VideoDecoder::interrupt() {
+    m_streamReader.interrupt();
+}
+
 void VideoDecoder::setForceSoftwareDecoding(bool force) {
     m_forceSoftwareDecoding = force;
     if (force) {
@@ -62,11 +134,14 @@ void VideoDecoder::setForceSoftwareDecoding(bool force) {
 void VideoDecoder::openFile() {
     closeFile();
 
-    const AVInputFormat* inputFormat = nullptr;
-
     QString qFileName = QString::fromStdString(m_fileName);
     QString formatIdentifier = VideoFormatUtils::detectFormatFromExtension(qFileName);
 
+    if (StreamFrameReader::isStreamPath(qFileName)) {
+        openStream(qFileName);
+        return;
+    }
+
     // Check if it's Y4M format
     if (VideoFormatUtils::getFormatType(formatIdentifier) == FormatType::Y4M) {
         m_isY4M = true;
@@ -107,7 +182,32 @@ void VideoDecoder::openFile() {
         metadata.setFilename(m_fileName);
         metadata.setCodecName("Y4M");
 
-        int totalFrames = Y4MParser::calculateTotalFrames(qFileName, m_y4mInfo);
+        // Kept open for the lifetime of the decoder, frames are read straight into the queue
+        m_y4mFile.setFileName(qFileName);
+        if (!m_y4mFile.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+            ErrorReporter::instance().report("Cannot open Y4M file for reading", LogLevel::Error);
+            return;
+        }
+        // Y4M payloads hold the planes back to back like a queue slot whose rows need no padding
+        if (metadata.isTightlyPacked()) {
+            m_asyncReader.open(qFileName);
+        }
+
+        // The frame marker scan reads the whole file, reuse it from the primary decoder or the cache when possible
+        MetadataCache::Entry cached;
+        bool offsetsCached = false;
+        if (m_probeSource && !m_probeSource->m_y4mFrameOffsets.empty()) {
+            cached.y4mFrameOffsets = m_probeSource->m_y4mFrameOffsets;
+            offsetsCached = true;
+        } else {
+            offsetsCached = MetadataCache::load(qFileName, cached) && !cached.y4mFrameOffsets.empty();
+        }
+        if (offsetsCached) {
+            m_y4mFrameOffsets = std::move(cached.y4mFrameOffsets);
+        } else {
+            m_y4mFrameOffsets = Y4MParser::buildFrameIndex(qFileName, m_y4mInfo);
+        }
+        int totalFrames = static_cast<int>(m_y4mFrameOffsets.size());
         metadata.setTotalFrames(totalFrames);
         yuvTotalFrames = totalFrames;
 
@@ -117,12 +217,63 @@ void VideoDecoder::openFile() {
 
         debug("vd", QString("Y4M file total frames: %1, duration: %2 ms").arg(totalFrames).arg(durationMs));
 
+        if (!offsetsCached && totalFrames > 0) {
+            cached.meta = metadata;
+            cached.frameRate = m_y4mInfo.frameRate;
+            cached.y4mFrameOffsets = m_y4mFrameOffsets;
+            MetadataCache::store(qFileName, cached);
+        }
+
         currentFrameIndex = 0;
         return;
     } else if (VideoFormatUtils::getFormatType(formatIdentifier) == FormatType::RAW_YUV) {
         m_isY4M = false;
-        inputFormat = av_find_input_format("rawvideo");
-        debug("vd", "Detected raw YUV file, using rawvideo input format");
+        m_isRawYUV = true;
+        m_rawFormat = m_format;
+
+        // Raw YUV frames sit at fixed offsets, serve them from a mapping instead of a demuxer
+        if (!m_rawReader.open(qFileName, calculateFrameSize(m_rawFormat, m_width, m_height))) {
+            return;
+        }
+        debug("vd", "Detected raw YUV file, reading frames through memory mapping");
+        debug("vd", QString("Pixel conversion kernels: %1").arg(PixelKernels::isaName(PixelKernels::best().isa)));
+
+        const AVPixFmtDescriptor* pixDesc = av_pix_fmt_desc_get(m_rawFormat);
+        int uvWidth = AV_CEIL_RSHIFT(m_width, pixDesc->log2_chroma_w);
+        int uvHeight = AV_CEIL_RSHIFT(m_height, pixDesc->log2_chroma_h);
+
+        metadata.setYWidth(m_width);
+        metadata.setYHeight(m_height);
+        metadata.setUVWidth(uvWidth);
+        metadata.setUVHeight(uvHeight);
+        // Packed 4:2:2 is converted to planar while loading unless the renderer unpacks it
+        if (isPackedYUV(m_rawFormat) && !m_gpuUnpack) {
+            metadata.setPixelFormat(AV_PIX_FMT_YUV422P);
+        } else {
+            metadata.setPixelFormat(m_rawFormat);
+        }
+        metadata.setTimeBase(av_inv_q(av_d2q(m_framerate, 1000000)));
+        metadata.setSampleAspectRatio({1, 1});
+        metadata.setColorRange(AVCOL_RANGE_UNSPECIFIED);
+        metadata.setColorSpace(AVCOL_SPC_UNSPECIFIED);
+        metadata.setFilename(m_fileName);
+        metadata.setCodecName("rawvideo");
+
+        // Frames stored exactly like a queue slot can be read into it without a copy
+        if (!(isPackedYUV(m_rawFormat) && !m_gpuUnpack) && metadata.isTightlyPacked() &&
+            m_rawReader.frameSize() == metadata.frameSize()) {
+            m_asyncReader.open(qFileName);
+        }
+
+        yuvTotalFrames = static_cast<int>(m_rawReader.frameCount());
+        metadata.setTotalFrames(yuvTotalFrames);
+        metadata.setDuration(getDurationMs());
+
+        debug("vd",
+              QString("Raw YUV file total frames: %1, duration: %2 ms").arg(yuvTotalFrames).arg(metadata.duration()));
+
+        currentFrameIndex = 0;
+        return;
     } else {
         m_isY4M = false;
     }
@@ -131,20 +282,27 @@ void VideoDecoder::openFile() {
     // av_dict_set(&input_options, "pixel_format", "yuv420p", 0);
 
     // Open input file
-    if (avformat_open_input(&formatContext, m_fileName.c_str(), inputFormat, &inputOptions) < 0) {
+    if (avformat_open_input(&formatContext, m_fileName.c_str(), nullptr, &inputOptions) < 0) {
         ErrorReporter::instance().report("Could not open input file " + m_fileName, LogLevel::Error);
         return;
     }
 
+    // A cached probe lets the container header stand in for the stream info scan, segment decoders take the
+    // primary's probe and leave the cache entry to it
+    MetadataCache::Entry cached;
+    bool probeShared = m_probeSource && copyProbe(*m_probeSource, cached);
+    bool probeCached = probeShared || (MetadataCache::load(qFileName, cached) && hasCachedStream(cached));
+
     // Retrieve stream information
-    if (avformat_find_stream_info(formatContext, nullptr) < 0) {
+    if (!probeCached && avformat_find_stream_info(formatContext, nullptr) < 0) {
         ErrorReporter::instance().report("Could not find stream information", LogLevel::Error);
         closeFile();
         return;
     }
 
     // Find the video stream
-    videoStreamIndex = av_find_best_stream(formatContext, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    videoStreamIndex =
+        probeCached ? cached.streamIndex : av_find_best_stream(formatContext, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
     if (videoStreamIndex < 0) {
         ErrorReporter::instance().report("Could not find video stream", LogLevel::Error);
         closeFile();
@@ -211,15 +369,32 @@ void VideoDecoder::openFile() {
         return;
     }
 
+    // Without the stream info scan the pixel format is only known once the first frame decodes
+    if (probeCached && codecContext->pix_fmt == AV_PIX_FMT_NONE) {
+        codecContext->pix_fmt = cached.meta.format();
+    }
+
     // Bind hardware device context if present
     if (hw_device_ctx) {
         codecContext->hw_device_ctx = av_buffer_ref(hw_device_ctx);
     }
 
+    // Software decoding spreads over frame and slice threads, 0 lets libavcodec pick the count.
+    // Hardware decoding only parses on the CPU and stays single threaded.
+    codecContext->thread_count = hw_device_ctx ? 1 : m_decodeThreads;
+    codecContext->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+
     if (!isYUV(codecContext->codec_id)) {
         setDimensions(codecContext->width, codecContext->height);
     }
 
+    m_directDecoding = canDecodeDirectly(codec);
+    if (m_directDecoding) {
+        codecContext->opaque = this;
+        codecContext->get_buffer2 = &VideoDecoder::getDirectBuffer;
+        debug("vd", QString("Direct decoding into frame queue enabled for %1").arg(codec->name));
+    }
+
     // Open codec
     if (avcodec_open2(codecContext, codec, nullptr) < 0) {
         ErrorReporter::instance().report("Could not open codec", LogLevel::Error);
@@ -227,6 +402,23 @@ void VideoDecoder::openFile() {
         return;
     }
 
+    // Reused for every frame and seek until the file is closed
+    m_packet = av_packet_alloc();
+    m_frame = av_frame_alloc();
+    m_transferFrame = av_frame_alloc();
+    m_pendingFrame = av_frame_alloc();
+    if (!m_packet || !m_frame || !m_transferFrame || !m_pendingFrame) {
+        ErrorReporter::instance().report("Could not allocate packet or frame", LogLevel::Error);
+        closeFile();
+        return;
+    }
+
+    debug("vd", QString("Decoding with %1 thread(s)").arg(codecContext->thread_count));
+
+    // Frame threads each decode their own frame, the count is only known once the codec is open
+    m_directFramesInFlight = (codecContext->active_thread_type & FF_THREAD_FRAME) ? codecContext->thread_count : 1;
+    m_directSlots.reserve(m_directFramesInFlight + 1);
+
     // Print final decoder status based on actual codec and hardware context
     bool isActuallyUsingHardware = (hw_device_ctx != nullptr) && (codecContext->hw_device_ctx != nullptr);
 
@@ -244,40 +436,41 @@ void VideoDecoder::openFile() {
         debug("vd", QString("Final status: Software decoding active - %1").arg(codec->name));
     }
 
-    // Calculate Y and UV dimensions using FFmpeg pixel format descriptor
-    const AVPixFmtDescriptor* pixDesc = av_pix_fmt_desc_get(codecContext->pix_fmt);
-    // int yWidth = codecContext->width;
-    // int yHeight = codecContext->height;
-    int uvWidth = AV_CEIL_RSHIFT(m_width, pixDesc->log2_chroma_w);
-    int uvHeight = AV_CEIL_RSHIFT(m_height, pixDesc->log2_chroma_h);
-
-    setDimensions(m_width, m_height);
-    metadata.setYWidth(m_width);
-    metadata.setYHeight(m_height);
-    metadata.setUVWidth(uvWidth);
-    metadata.setUVHeight(uvHeight);
-    metadata.setPixelFormat(codecContext->pix_fmt);
-    metadata.setTimeBase(videoStream->time_base);
-    metadata.setSampleAspectRatio(videoStream->sample_aspect_ratio);
-    metadata.setColorRange(codecContext->color_range);
-    metadata.setColorSpace(codecContext->colorspace);
-    metadata.setFilename(m_fileName);
-    metadata.setCodecName(codec->name ? std::string(codec->name) : "Unknown");
-    metadata.setDuration(getDurationMs());
-    metadata.setTotalFrames(getTotalFrames());
-    setFormat(codecContext->pix_fmt);
-
-    if (isYUV(codecContext->codec_id)) {
-        int frameSize = calculateFrameSize(codecContext->pix_fmt, m_width, m_height);
-
-        QFileInfo info(QString::fromStdString(m_fileName));
-        int64_t fileSize = info.size();
-        yuvTotalFrames = fileSize / frameSize;
-        metadata.setTotalFrames(yuvTotalFrames);
+    if (probeCached) {
+        metadata = cached.meta;
+        metadata.setFilename(m_fileName);
+        setDimensions(metadata.yWidth(), metadata.yHeight());
+        setFormat(metadata.format());
+        setFramerate(cached.frameRate);
+        m_needsTimebaseConversion = cached.needsTimebaseConversion;
+        m_indexedTotalFrames = metadata.totalFrames();
     } else {
+        // The metadata describes the frames as they are stored in the queue, not as they are decoded
+        AVPixelFormat storedFormat = slotFormat(codecContext->pix_fmt);
+        const AVPixFmtDescriptor* pixDesc = av_pix_fmt_desc_get(storedFormat);
+        // int yWidth = codecContext->width;
+        // int yHeight = codecContext->height;
+        int uvWidth = AV_CEIL_RSHIFT(m_width, pixDesc->log2_chroma_w);
+        int uvHeight = AV_CEIL_RSHIFT(m_height, pixDesc->log2_chroma_h);
+
+        setDimensions(m_width, m_height);
+        metadata.setYWidth(m_width);
+        metadata.setYHeight(m_height);
+        metadata.setUVWidth(uvWidth);
+        metadata.setUVHeight(uvHeight);
+        metadata.setPixelFormat(storedFormat);
+        metadata.setTimeBase(videoStream->time_base);
+        metadata.setSampleAspectRatio(videoStream->sample_aspect_ratio);
+        metadata.setColorRange(codecContext->color_range);
+        metadata.setColorSpace(codecContext->colorspace);
+        metadata.setFilename(m_fileName);
+        metadata.setCodecName(codec->name ? std::string(codec->name) : "Unknown");
+        metadata.setDuration(getDurationMs());
+        metadata.setTotalFrames(getTotalFrames());
+        setFormat(codecContext->pix_fmt);
+
         AVRational timeBase = videoStream->time_base;
         AVRational frameRate = videoStream->avg_frame_rate;
-        metadata.setTotalFrames(getTotalFrames());
         setFramerate(frameRate.num);
 
         if (frameRate.num == 0 && timeBase.den == 0) {
@@ -298,6 +491,41 @@ void VideoDecoder::openFile() {
     debug("vd", QString("Timebase: %1/%2").arg(metadata.timeBase().num).arg(metadata.timeBase().den));
     debug("vd", QString("Framerate: %1").arg(m_framerate));
 
+    // Frame indices count from the first frame of the stream. Known up front, a decoder whose first decode
+    // follows a seek does not take the keyframe it lands on for the first frame.
+    int64_t startTime = probeCached ? cached.startTime : videoStream->start_time;
+    if (probeShared) {
+        m_ptsOffset = m_probeSource->m_ptsOffset.load();
+    } else if (startTime != AV_NOPTS_VALUE) {
+        m_ptsOffset = std::max<int64_t>(rescalePts(startTime), 0);
+    }
+
+    if (probeShared) {
+        m_keyframeIndex = m_probeSource->m_keyframeIndex;
+    } else if (probeCached && !cached.packets.empty()) {
+        m_keyframeIndex->load(std::move(cached.packets));
+    } else {
+        // Seeks fall back to the demuxer's own heuristics until the index is ready
+        cached.meta = metadata;
+        cached.streamIndex = videoStreamIndex;
+        cached.frameRate = m_framerate;
+        cached.needsTimebaseConversion = m_needsTimebaseConversion;
+        cached.startTime = startTime;
+        cached.packets.clear();
+        MetadataCache::store(qFileName, cached);
+
+        auto storeIndex = [qFileName, cached](const std::vector<KeyframeIndex::Entry>& entries) mutable {
+            // Containers without a frame count get one from the packet index on the next open
+            if (cached.meta.totalFrames() <= 0) {
+                cached.meta.setTotalFrames(static_cast<int>(entries.size()));
+            }
+            cached.packets = entries;
+            MetadataCache::store(qFileName, cached);
+        };
+        m_keyframeIndex->build(m_fileName, videoStreamIndex, storeIndex);
+    }
+
+    m_packetQueue.start(formatContext, videoStreamIndex);
     currentFrameIndex = 0;
 }
 
@@ -327,16 +555,18 @@ void VideoDecoder::loadFrames(int num_frames, int direction = 1) {
     // Y4M files have special processing logic
     if (m_isY4M) {
         // Y4M file processing logic
+    } else if (m_isRawYUV) {
+        if (!m_rawReader.isOpen() && !m_streamReader.isOpen()) {
+            ErrorReporter::instance().report("VideoDecoder not properly initialized", LogLevel::Error);
+            emit framesLoaded(false);
+            return;
+        }
     } else if (!formatContext || !codecContext) {
         ErrorReporter::instance().report("VideoDecoder not properly initialized", LogLevel::Error);
         emit framesLoaded(false);
         return;
     }
 
-    bool isRawYUV = !m_isY4M && isYUV(codecContext->codec_id);
-    int64_t maxpts = -1;
-    int64_t minpts = INT64_MAX;
-
     debug("vd",
           QString("loadFrames called with num_frames: %1, direction: %2, currentFrameIndex: %3")
               .arg(num_frames)
@@ -347,7 +577,7 @@ void VideoDecoder::loadFrames(int num_frames, int direction = 1) {
     if (direction == -1) {
         if (currentFrameIndex == 0) {
             debug("vd", "At the beginning of the video, cannot seek backward");
-            m_frameQueue->updateTail(0);
+            publishTail(0);
             ErrorReporter::instance().report("Cannot seek backward", LogLevel::Warning);
             emit framesLoaded(false);
             return;
@@ -357,23 +587,112 @@ void VideoDecoder::loadFrames(int num_frames, int direction = 1) {
             currentFrameIndex = 0;
             direction = 1; // Change direction to forward if we hit the beginning
         }
-        seekTo(currentFrameIndex);
-        debug("vd", QString("seeking to %1").arg(currentFrameIndex));
         // Make sure we don't load more than half of the queue size
         num_frames = std::min(num_frames, m_frameQueue->getSize() / 2);
+
+        // Long-GOP streams decode each GOP once and play it back from the side buffer
+        if (usesReverseCache() && m_ptsOffset >= 0) {
+            int64_t loaded = loadReverseFrames(currentFrameIndex, currentFrameIndex + num_frames - 1);
+            publishTail(loaded);
+            m_position.store(currentFrameIndex, std::memory_order_release);
+            emit framesLoaded(true);
+            return;
+        }
+
+        seekTo(currentFrameIndex);
+        debug("vd", QString("seeking to %1").arg(currentFrameIndex));
+    } else if (usesReverseCache() && (m_reverseResync || !m_reverseCache.empty())) {
+        // Playing forward again, the demuxer still sits wherever the last GOP decode stopped
+        clearReverseCache();
+        if (m_reverseResync) {
+            seekTo(currentFrameIndex);
+        }
     }
 
     localTail = currentFrameIndex;
+    int64_t maxpts = loadSequential(num_frames);
+
+    debug("vd", QString("Loaded from %1 to %2 in direction %3").arg(localTail).arg(currentFrameIndex).arg(direction));
+
+    publishTail(maxpts);
+    m_position.store(currentFrameIndex, std::memory_order_release);
+    emit framesLoaded(!m_batchFailed);
+}
+
+void VideoDecoder::publishTail(int64_t pts) {
+    if (m_publishTail.load(std::memory_order_relaxed)) {
+        m_frameQueue->updateTail(pts);
+    }
+}
+
+/**
+ * @brief Loads count frames from first on without moving the queue tail.
+ *
+ * Used when several decoders fill adjacent ranges of one batch, the controller publishes the tail
+ * once the whole batch is in.
+ */
+void VideoDecoder::loadRange(int64_t first, int count) {
+    if (count <= 0) {
+        emit rangeLoaded(-1);
+        return;
+    }
+
+    if (first != currentFrameIndex) {
+        seekTo(first);
+    }
+    int64_t maxpts = loadSequential(count);
+    debug("vd", QString("Loaded range %1 to %2").arg(first).arg(maxpts));
+
+    m_position.store(currentFrameIndex, std::memory_order_release);
+    emit rangeLoaded(maxpts);
+}
+
+/**
+ * @brief Loads up to num_frames frames forward from currentFrameIndex into the queue
+ * @return Highest PTS loaded, -1 when nothing was loaded
+ */
+int64_t VideoDecoder::loadSequential(int num_frames) {
+    bool isRawYUV = m_isRawYUV;
+    int64_t maxpts = -1;
+    m_batchFailed = false;
+
+    // Raw and Y4M frames are read with several requests in flight when io_uring is available
+    if (m_asyncReader.isOpen() && (isRawYUV || m_isY4M)) {
+        int64_t lastPts = loadFramesAsync(num_frames);
+        if (lastPts >= 0) {
+            return lastPts;
+        }
+    }
+
+    if (isRawYUV) {
+        m_rawReader.prefetch(currentFrameIndex, num_frames);
+    }
+
+    int loadedFrames = 0;
+    uint64_t allocationsBefore = AllocationCounter::threadAllocations();
 
     for (int i = 0; i < num_frames; ++i) {
         int64_t temp_pts;
         if (m_isY4M) {
             temp_pts = loadY4MFrame();
         } else if (isRawYUV) {
-            temp_pts = loadYUVFrame();
+            // Live streams only wait for the first frame, the rest of the batch takes what already arrived
+            temp_pts = loadYUVFrame(i == 0);
         } else {
             temp_pts = loadCompressedFrame();
-            debug("vd", QString("loadCompressedFrame returned pts: %1").arg(temp_pts));
+            if (DebugManager::instance().isEnabled(QStringLiteral("vd"))) {
+                debug("vd", QString("loadCompressedFrame returned pts: %1").arg(temp_pts));
+            }
+        }
+
+        // Already reported, decoding goes on with the next frame
+        if (temp_pts == kFrameFailed) {
+            continue;
+        }
+
+        // Frames of a live stream still on their way, or no longer kept
+        if (temp_pts == -1 && m_isStream && !m_streamReader.atEnd()) {
+            break;
         }
 
         // EOF
@@ -387,13 +706,9 @@ void VideoDecoder::loadFrames(int num_frames, int direction = 1) {
                     lastFramePts = totalFrames - 1;
                 }
 
-                FrameData* lastFrame = m_frameQueue->getTailFrame(lastFramePts);
-                if (lastFrame) {
-                    lastFrame->setEndFrame(true);
-                    debug(
-                        "vd",
-                        QString("Marked frame %1 as end frame (total frames: %2)").arg(lastFramePts).arg(totalFrames));
-                }
+                m_frameQueue->markEndFrame(lastFramePts);
+                debug("vd",
+                      QString("Marked frame %1 as end frame (total frames: %2)").arg(lastFramePts).arg(totalFrames));
             }
             break;
         }
@@ -401,37 +716,92 @@ void VideoDecoder::loadFrames(int num_frames, int direction = 1) {
         if (!isRawYUV && !m_isY4M) {
             int totalFrames = getTotalFrames();
             if (totalFrames > 0 && temp_pts >= totalFrames - 1) {
-                FrameData* endFrame = m_frameQueue->getTailFrame(temp_pts);
-                if (endFrame) {
-                    endFrame->setEndFrame(true);
-                    debug("vd",
-                          QString("Marked frame %1 as end frame (reached total frames: %2)")
-                              .arg(temp_pts)
-                              .arg(totalFrames));
-                }
+                m_frameQueue->markEndFrame(temp_pts);
+                debug("vd",
+                      QString("Marked frame %1 as end frame (reached total frames: %2)")
+                          .arg(temp_pts)
+                          .arg(totalFrames));
             }
         }
 
         maxpts = std::max(maxpts, temp_pts);
-        minpts = std::min(minpts, std::max(temp_pts, (int64_t)0));
+        ++loadedFrames;
     }
 
-    debug("vd", QString("Loaded from %1 to %2 in direction %3").arg(localTail).arg(currentFrameIndex).arg(direction));
-
-    if (direction == 1) {
-        m_frameQueue->updateTail(maxpts);
-    } else {
-        m_frameQueue->updateTail(maxpts);
+    if (AllocationCounter::isEnabled() && loadedFrames > 0) {
+        uint64_t allocations = AllocationCounter::threadAllocations() - allocationsBefore;
+        debug("vd",
+              QString("Heap allocations outside FFmpeg: %1 for %2 frames, %3 per frame")
+                  .arg(allocations)
+                  .arg(loadedFrames)
+                  .arg(static_cast<double>(allocations) / loadedFrames));
     }
 
-    emit framesLoaded(true);
+    return maxpts;
 }
 
 FrameMeta VideoDecoder::getMetaData() {
     return metadata;
 }
 
+/**
+ * @brief Opens stdin or a named pipe carrying raw or Y4M frames.
+ *
+ * Frames are served through the raw YUV path. The total frame count stays unknown, so playback
+ * treats the video as live until the producer closes the stream.
+ */
+void VideoDecoder::openStream(const QString& fileName) {
+    m_isY4M = false;
+    m_isRawYUV = true;
+    m_isStream = true;
+
+    // Y4M streams describe themselves, raw ones rely on the dimensions and format given on the command line
+    int64_t rawFrameSize = 0;
+    if (m_format != AV_PIX_FMT_NONE && m_width > 0 && m_height > 0) {
+        rawFrameSize = calculateFrameSize(m_format, m_width, m_height);
+    }
+    if (!m_streamReader.open(fileName, rawFrameSize, m_streamHistory)) {
+        return;
+    }
+    if (m_streamReader.isY4M()) {
+        const Y4MInfo& info = m_streamReader.y4mInfo();
+        setDimensions(info.width, info.height);
+        setFramerate(info.frameRate);
+        setFormat(info.pixelFormat);
+    }
+    m_rawFormat = m_format;
+
+    const AVPixFmtDescriptor* pixDesc = av_pix_fmt_desc_get(m_rawFormat);
+    int uvWidth = AV_CEIL_RSHIFT(m_width, pixDesc->log2_chroma_w);
+    int uvHeight = AV_CEIL_RSHIFT(m_height, pixDesc->log2_chroma_h);
+
+    metadata.setYWidth(m_width);
+    metadata.setYHeight(m_height);
+    metadata.setUVWidth(uvWidth);
+    metadata.setUVHeight(uvHeight);
+    if (isPackedYUV(m_rawFormat) && !m_gpuUnpack) {
+        metadata.setPixelFormat(AV_PIX_FMT_YUV422P);
+    } else {
+        metadata.setPixelFormat(m_rawFormat);
+    }
+    metadata.setTimeBase(av_inv_q(av_d2q(m_framerate, 1000000)));
+    metadata.setSampleAspectRatio({1, 1});
+    metadata.setColorRange(AVCOL_RANGE_UNSPECIFIED);
+    metadata.setColorSpace(AVCOL_SPC_UNSPECIFIED);
+    metadata.setFilename(m_fileName);
+    metadata.setCodecName(m_streamReader.isY4M() ? "Y4M" : "rawvideo");
+
+    yuvTotalFrames = -1;
+    metadata.setTotalFrames(-1);
+    metadata.setDuration(-1);
+    currentFrameIndex = 0;
+}
+
 void VideoDecoder::closeFile() {
+    // The last decoder holding the index cancels a build still running
+    m_keyframeIndex = std::make_shared<KeyframeIndex>();
+    m_packetQueue.stop();
+
     if (codecContext) {
         avcodec_free_context(&codecContext);
         codecContext = nullptr;
@@ -447,9 +817,40 @@ void VideoDecoder::closeFile() {
         hw_device_ctx = nullptr;
     }
 
+    if (m_swsContext) {
+        sws_freeContext(m_swsContext);
+        m_swsContext = nullptr;
+    }
+
+    av_packet_free(&m_packet);
+    av_frame_free(&m_frame);
+    av_frame_free(&m_transferFrame);
+    av_frame_free(&m_pendingFrame);
+    m_hasPendingFrame = false;
+    abandonDirectSlots();
+    clearReverseCache();
+    m_reverseResync = false;
+    m_ptsOffset = -1;
+    m_indexedTotalFrames = -1;
+
+    m_rawReader.close();
+    m_asyncReader.close();
+    m_streamReader.close();
+    m_isRawYUV = false;
+    m_isStream = false;
+
+    if (m_y4mFile.isOpen()) {
+        m_y4mFile.close();
+    }
+    m_y4mFrameOffsets.clear();
+
     hw_pix_fmt = AV_PIX_FMT_NONE;
+    m_directDecoding = false;
+    m_directMinPts = 0;
+    m_directFramesInFlight = 1;
     videoStreamIndex = -1;
     currentFrameIndex = 0;
+    m_position.store(0, std::memory_order_release);
 }
 
 bool VideoDecoder::isYUV(AVCodecID codecId) {
@@ -524,459 +925,578 @@ bool VideoDecoder::initializeHardwareDecoder(AVHWDeviceType deviceType, AVPixelF
     return true;
 }
 
-int64_t VideoDecoder::loadYUVFrame() {
-    AVPacket* tempPacket = av_packet_alloc();
-    if (!tempPacket) {
-        ErrorReporter::instance().report("Could not allocate packet", LogLevel::Error);
-        emit framesLoaded(false);
-        return -1;
-    }
-
-    int ret;
-    int64_t pts = -1;
-    while ((ret = av_read_frame(formatContext, tempPacket)) >= 0) {
-        if (tempPacket->stream_index == videoStreamIndex) {
-            int retFlag;
-            pts = currentFrameIndex;
-            FrameData* frameData = m_frameQueue->getTailFrame(pts);
-            copyFrame(tempPacket, frameData, retFlag);
-            if (retFlag == 2)
-                break;
-            av_packet_free(&tempPacket);
-            return pts;
-        }
-        av_packet_unref(tempPacket);
+bool VideoDecoder::isIntraOnly() const {
+    if (m_isY4M || m_isRawYUV) {
+        return true;
     }
-
-    if (ret < 0 && ret != AVERROR_EOF) {
-        ErrorReporter::instance().report("Failed to read raw YUV frame", LogLevel::Error);
+    if (!codecContext) {
+        return false;
     }
+    const AVCodecDescriptor* descriptor = avcodec_descriptor_get(codecContext->codec_id);
+    return descriptor && (descriptor->props & AV_CODEC_PROP_INTRA_ONLY);
+}
 
-    av_packet_free(&tempPacket);
-    return pts;
+bool VideoDecoder::usesReverseCache() const {
+    // Intra-only streams seek to any frame directly, their slots may also be decoder owned
+    return !m_isY4M && !m_isRawYUV && codecContext && !m_directDecoding;
 }
 
-int64_t VideoDecoder::loadCompressedFrame() {
-    // Allocate packet for decoding operation
-    AVPacket* tempPacket = av_packet_alloc();
-    if (!tempPacket) {
-        ErrorReporter::instance().report("Could not allocate packet", LogLevel::Error);
-        emit framesLoaded(false);
-        return -1;
+bool VideoDecoder::hasCachedStream(const MetadataCache::Entry& cached) const {
+    if (cached.streamIndex < 0 || cached.streamIndex >= static_cast<int>(formatContext->nb_streams)) {
+        return false;
     }
 
-    int ret;
-    int64_t normalized_pts = -1;
-    bool eof_reached = false;
-    AVPixelFormat dstFormat = AV_PIX_FMT_YUV420P;
-
-    while ((ret = av_read_frame(formatContext, tempPacket)) >= 0 || !eof_reached) {
-        if (ret < 0) {
-            eof_reached = true;
-            ret = avcodec_send_packet(codecContext, nullptr);
-        } else if (tempPacket->stream_index == videoStreamIndex) {
-            ret = avcodec_send_packet(codecContext, tempPacket);
-            if (ret < 0) {
-                ErrorReporter::instance().report("Failed to send packet to decoder", LogLevel::Error);
-                av_packet_unref(tempPacket);
-                break;
-            }
-        } else {
-            av_packet_unref(tempPacket);
-            continue;
-        }
-
-        while (true) {
-            AVFrame* tempFrame = av_frame_alloc();
-            if (!tempFrame) {
-                ErrorReporter::instance().report("Could not allocate temporary frame", LogLevel::Error);
-                if (!eof_reached)
-                    av_packet_unref(tempPacket);
-                av_packet_free(&tempPacket);
-                return -1;
-            }
-
-            ret = avcodec_receive_frame(codecContext, tempFrame);
+    // Headerless streams such as raw Annex B only learn their parameters from the stream info scan
+    const AVCodecParameters* codecpar = formatContext->streams[cached.streamIndex]->codecpar;
+    return codecpar->codec_type == AVMEDIA_TYPE_VIDEO && codecpar->codec_id != AV_CODEC_ID_NONE &&
+           codecpar->width > 0 && codecpar->height > 0 && cached.meta.format() != AV_PIX_FMT_NONE;
+}
 
-            if (ret == 0) {
-                int64_t raw_pts = tempFrame->pts;
+/**
+ * @brief Takes the stream the primary decoder of the same file probed.
+ *
+ * Fills entry like a metadata cache hit and hands the probed codec parameters to this decoder's
+ * demuxer, so the file is neither scanned for stream info nor looked up in the cache again.
+ */
+bool VideoDecoder::copyProbe(const VideoDecoder& primary, MetadataCache::Entry& entry) {
+    int streamIndex = primary.videoStreamIndex;
+    if (!primary.formatContext || streamIndex < 0 || streamIndex >= static_cast<int>(formatContext->nb_streams)) {
+        return false;
+    }
 
-                normalized_pts = raw_pts;
-                if (m_needsTimebaseConversion && raw_pts != AV_NOPTS_VALUE) {
-                    AVStream* videoStream = formatContext->streams[videoStreamIndex];
-                    double frame_time = av_q2d(videoStream->time_base) * raw_pts;
-                    normalized_pts = llrint(frame_time * m_framerate);
-                }
+    const AVCodecParameters* codecpar = primary.formatContext->streams[streamIndex]->codecpar;
+    if (avcodec_parameters_copy(formatContext->streams[streamIndex]->codecpar, codecpar) < 0) {
+        return false;
+    }
 
-                if (m_ptsOffset == -1 && normalized_pts >= 0) {
-                    m_ptsOffset = normalized_pts;
-                }
+    entry.meta = primary.metadata;
+    entry.streamIndex = streamIndex;
+    entry.frameRate = primary.m_framerate;
+    entry.needsTimebaseConversion = primary.m_needsTimebaseConversion;
+    return true;
+}
 
-                normalized_pts -= m_ptsOffset;
-
-                FrameData* frameData = m_frameQueue->getTailFrame(normalized_pts);
-
-                int width = metadata.yWidth();
-                int height = metadata.yHeight();
-
-                // Always use target format descriptor for output
-                const AVPixFmtDescriptor* pixDesc = av_pix_fmt_desc_get(dstFormat);
-                int uvWidth = AV_CEIL_RSHIFT(width, pixDesc->log2_chroma_w);
-
-                uint8_t* dstData[4] = {frameData->yPtr(), frameData->uPtr(), frameData->vPtr(), nullptr};
-                int dstLinesize[4] = {width, uvWidth, uvWidth, 0};
-
-                // Hardware frame transfer if needed
-                AVFrame* outputFrame = nullptr;
-                if (hw_device_ctx && tempFrame->format == hw_pix_fmt) {
-                    outputFrame = av_frame_alloc();
-                    if (!outputFrame) {
-                        ErrorReporter::instance().report("Could not allocate output frame", LogLevel::Error);
-                        av_frame_free(&tempFrame);
-                        av_packet_unref(tempPacket);
-                        break;
-                    }
-                    if (av_hwframe_transfer_data(outputFrame, tempFrame, 0) < 0) {
-                        ErrorReporter::instance().report("Failed to transfer frame from GPU to CPU", LogLevel::Error);
-                        av_frame_free(&outputFrame);
-                        av_frame_free(&tempFrame);
-                        av_packet_unref(tempPacket);
-                        break;
-                    }
-                } else {
-                    outputFrame = tempFrame;
-                }
+/**
+ * @brief Checks whether frames can be decoded straight into FrameQueue slots.
+ *
+ * Only intra-only software decoders qualify: they never keep a frame as reference, so a slot is
+ * free again as soon as the frame is handed out. Slot rows are padded to FrameMeta::alignedStride(),
+ * which has to cover the decoder's aligned width, but there are no spare rows below a plane.
+ */
+bool VideoDecoder::canDecodeDirectly(const AVCodec* codec) {
+    if (hw_device_ctx || !(codec->capabilities & AV_CODEC_CAP_DR1)) {
+        return false;
+    }
 
-                SwsContext* swsCtx = sws_getContext(outputFrame->width,
-                                                    outputFrame->height,
-                                                    (AVPixelFormat)outputFrame->format,
-                                                    width,
-                                                    height,
-                                                    dstFormat,
-                                                    SWS_BILINEAR,
-                                                    nullptr,
-                                                    nullptr,
-                                                    nullptr);
-
-                if (swsCtx) {
-                    sws_scale(swsCtx,
-                              (const uint8_t* const*)outputFrame->data,
-                              outputFrame->linesize,
-                              0,
-                              outputFrame->height,
-                              dstData,
-                              dstLinesize);
-                    sws_freeContext(swsCtx);
-
-                    if (outputFrame != tempFrame) {
-                        av_frame_free(&outputFrame);
-                    }
-
-                    // Set pts to normalized pts
-                    frameData->setPts(normalized_pts);
-                    frameData->setEndFrame(false);
-                    currentFrameIndex = normalized_pts + 1;
-
-                    debug("vd",
-                          QString("loadCompressedFrame loaded frame %1 from raw PTS %2 at queue index %3")
-                              .arg(normalized_pts)
-                              .arg(raw_pts)
-                              .arg(normalized_pts));
-
-                    av_frame_free(&tempFrame);
-                    if (!eof_reached)
-                        av_packet_unref(tempPacket);
-                    av_packet_free(&tempPacket);
-                    return normalized_pts;
-                } else {
-                    ErrorReporter::instance().report("Failed to create swsContext for YUV conversion", LogLevel::Error);
-                    emit framesLoaded(false);
-                    if (outputFrame != tempFrame)
-                        av_frame_free(&outputFrame);
-                    av_frame_free(&tempFrame);
-                    metadata.setPixelFormat(dstFormat);
-                    setFormat(dstFormat);
-                    if (!eof_reached)
-                        av_packet_unref(tempPacket);
-                    av_packet_free(&tempPacket);
-                    return -1;
-                }
-            } else if (ret == AVERROR(EAGAIN)) {
-                av_frame_free(&tempFrame);
-                break;
-            } else if (ret == AVERROR_EOF) {
-                av_frame_free(&tempFrame);
-                av_packet_free(&tempPacket);
-                return -1;
-            } else {
-                av_frame_free(&tempFrame);
-                break;
-            }
-        }
+    const AVCodecDescriptor* descriptor = avcodec_descriptor_get(codec->id);
+    if (!descriptor || !(descriptor->props & AV_CODEC_PROP_INTRA_ONLY)) {
+        return false;
+    }
 
-        if (!eof_reached) {
-            av_packet_unref(tempPacket);
-        }
+    if (codecContext->pix_fmt != AV_PIX_FMT_YUV420P) {
+        return false;
     }
 
-    if (ret < 0 && ret != AVERROR_EOF) {
-        ErrorReporter::instance().report("Failed to read frame", LogLevel::Error);
+    int alignedWidth = m_width;
+    int alignedHeight = m_height;
+    int linesizeAlign[AV_NUM_DATA_POINTERS];
+    avcodec_align_dimensions2(codecContext, &alignedWidth, &alignedHeight, linesizeAlign);
+    int yStride = FrameMeta::alignedStride(m_width);
+    int uvStride = FrameMeta::alignedStride(AV_CEIL_RSHIFT(m_width, 1));
+    if (alignedWidth > yStride || AV_CEIL_RSHIFT(alignedWidth, 1) > uvStride || alignedHeight != m_height) {
+        return false;
     }
 
-    av_packet_free(&tempPacket);
-    return -1;
+    return yStride % linesizeAlign[0] == 0 && uvStride % linesizeAlign[1] == 0 && uvStride % linesizeAlign[2] == 0;
 }
 
 /**
- * @brief Copies the decoded frame data into the provided FrameData structure.
- *
- * This function handles the copying of raw YUV frame data while preserving the original format
- * and populates the FrameData structure with the Y, U, and V plane pointers.
+ * @brief get_buffer2 callback handing out the FrameQueue slot of the frame being decoded.
  *
- * @param tempPacket Pointer to the AVPacket containing the decoded frame data.
- * @param frameData Pointer to the FrameData structure to populate.
- * @param retFlag Reference to an integer flag indicating success or failure of the operation.
+ * Called from the codec worker threads. Falls back to the default allocator whenever the slot
+ * cannot be predicted, e.g. before the PTS offset is known or for frames that are only decoded to
+ * reach a seek target, and when the queue has no slot to spare for every frame in flight. Waiting
+ * for a slot here could wait on the frames the same decoder still has to hand out.
  */
-void VideoDecoder::copyFrame(AVPacket*& tempPacket, FrameData* frameData, int& retFlag) {
-    retFlag = 1;
-    uint8_t* packetData = tempPacket->data;
+int VideoDecoder::getDirectBuffer(AVCodecContext* ctx, AVFrame* frame, int flags) {
+    VideoDecoder* decoder = static_cast<VideoDecoder*>(ctx->opaque);
+    int64_t ptsOffset = decoder ? decoder->m_ptsOffset.load() : -1;
+    if (!decoder || !decoder->m_directDecoding || ptsOffset == -1 || frame->pts == AV_NOPTS_VALUE ||
+        frame->format != AV_PIX_FMT_YUV420P || frame->width != decoder->metadata.yWidth() ||
+        frame->height != decoder->metadata.yHeight()) {
+        return avcodec_default_get_buffer2(ctx, frame, flags);
+    }
 
-    AVPixelFormat srcFmt = codecContext->pix_fmt;
-    int width = metadata.yWidth();
-    int height = metadata.yHeight();
+    int64_t pts = decoder->rescalePts(frame->pts) - ptsOffset;
+    if (pts < decoder->m_directMinPts) {
+        return avcodec_default_get_buffer2(ctx, frame, flags);
+    }
 
-    const AVPixFmtDescriptor* pixDesc = av_pix_fmt_desc_get(srcFmt);
-    if (!pixDesc) {
-        ErrorReporter::instance().report("Failed to get pixel format descriptor", LogLevel::Error);
-        retFlag = 2;
-        return;
+    // The queue shrinks when the arena reclaims slots, playback needs as many again as are in flight
+    if (decoder->m_frameQueue->getSize() < 2 * decoder->m_directFramesInFlight) {
+        return avcodec_default_get_buffer2(ctx, frame, flags);
     }
 
-    // Handle packed YUV formats differently
-    if (isPackedYUV(srcFmt)) {
-        debug("vd",
-              QString("Processing packed YUV format: %1 Dimensions: %2x%3 Packet size: %4")
-                  .arg(av_get_pix_fmt_name(srcFmt))
-                  .arg(width)
-                  .arg(height)
-                  .arg(tempPacket->size));
+    FrameData* slot = decoder->m_frameQueue->tryGetTailFrame(pts);
+    if (!slot) {
+        return avcodec_default_get_buffer2(ctx, frame, flags);
+    }
+    if (reinterpret_cast<uintptr_t>(slot->yPtr()) % FrameMeta::kPlaneAlignment != 0) {
+        slot->setPts(-1);
+        return avcodec_default_get_buffer2(ctx, frame, flags);
+    }
 
-        uint8_t* yPtr = frameData->yPtr();
-        uint8_t* uPtr = frameData->uPtr();
-        uint8_t* vPtr = frameData->vPtr();
+    size_t slotSize = decoder->metadata.frameSize();
 
-        // Verify pointers are valid
-        if (!yPtr || !uPtr || !vPtr) {
-            ErrorReporter::instance().report("Invalid frame data pointers", LogLevel::Error);
-            retFlag = 2;
-            return;
+    // The slot is owned by the queue, the buffer reference only tracks the decoder's usage. It stays
+    // claimed and invisible to readers until the decoded frame is published.
+    frame->buf[0] = av_buffer_create(slot->yPtr(), slotSize, [](void*, uint8_t*) {}, nullptr, 0);
+    if (!frame->buf[0]) {
+        slot->setPts(-1);
+        return AVERROR(ENOMEM);
+    }
+    {
+        QMutexLocker locker(&decoder->m_directMutex);
+        decoder->m_directSlots.emplace_back(slot, pts);
+    }
+
+    frame->data[0] = slot->yPtr();
+    frame->data[1] = slot->uPtr();
+    frame->data[2] = slot->vPtr();
+    frame->linesize[0] = slot->yStride();
+    frame->linesize[1] = slot->uvStride();
+    frame->linesize[2] = slot->uvStride();
+    frame->extended_data = frame->data;
+    return 0;
+}
+
+FrameData* VideoDecoder::takeDirectSlot(const AVFrame* frame, int64_t* pts) {
+    QMutexLocker locker(&m_directMutex);
+    for (size_t i = 0; i < m_directSlots.size(); ++i) {
+        if (m_directSlots[i].first->yPtr() == frame->data[0]) {
+            FrameData* slot = m_directSlots[i].first;
+            *pts = m_directSlots[i].second;
+            m_directSlots[i] = m_directSlots.back();
+            m_directSlots.pop_back();
+            return slot;
         }
+    }
+    return nullptr;
+}
 
-        // Convert packed YUV to planar YUV422P for internal processing (optimized)
-        if (srcFmt == AV_PIX_FMT_UYVY422) {
-            // UYVY: U0 Y0 V0 Y1 (4 bytes for 2 pixels)
-            debug("vd", "Converting UYVY422 to YUV422P...");
+// Unrefs a frame that does not go to the queue, a slot it was decoded into is free again
+void VideoDecoder::discardFrame(AVFrame* frame) {
+    int64_t pts = -1;
+    FrameData* slot = takeDirectSlot(frame, &pts);
+    av_frame_unref(frame);
+    if (slot) {
+        slot->setPts(-1);
+    }
+}
 
-            const int uvWidth = width / 2;
+// Frees the slots of frames dropped inside the codec, only valid once no frame is in flight
+void VideoDecoder::abandonDirectSlots() {
+    QMutexLocker locker(&m_directMutex);
+    for (const auto& claimed : m_directSlots) {
+        claimed.first->setPts(-1);
+    }
+    m_directSlots.clear();
+}
 
-            // Optimized conversion with better memory access patterns
-            for (int y = 0; y < height; y++) {
-                const uint8_t* srcLine = packetData + y * width * 2;
-                uint8_t* yLine = yPtr + y * width;
-                uint8_t* uLine = uPtr + y * uvWidth;
-                uint8_t* vLine = vPtr + y * uvWidth;
-
-                // Process 16 pixels at a time for better cache locality and reduced loop overhead
-                int x = 0;
-                for (; x <= width - 16; x += 16) {
-                    const uint8_t* src = srcLine + x * 2;
-
-                    // Extract Y values (16 pixels) - unrolled for better performance
-                    yLine[x] = src[1];       // Y0
-                    yLine[x + 1] = src[3];   // Y1
-                    yLine[x + 2] = src[5];   // Y2
-                    yLine[x + 3] = src[7];   // Y3
-                    yLine[x + 4] = src[9];   // Y4
-                    yLine[x + 5] = src[11];  // Y5
-                    yLine[x + 6] = src[13];  // Y6
-                    yLine[x + 7] = src[15];  // Y7
-                    yLine[x + 8] = src[17];  // Y8
-                    yLine[x + 9] = src[19];  // Y9
-                    yLine[x + 10] = src[21]; // Y10
-                    yLine[x + 11] = src[23]; // Y11
-                    yLine[x + 12] = src[25]; // Y12
-                    yLine[x + 13] = src[27]; // Y13
-                    yLine[x + 14] = src[29]; // Y14
-                    yLine[x + 15] = src[31]; // Y15
-
-                    // Extract U values (8 UV pairs)
-                    uLine[x / 2] = src[0];      // U0
-                    uLine[x / 2 + 1] = src[4];  // U1
-                    uLine[x / 2 + 2] = src[8];  // U2
-                    uLine[x / 2 + 3] = src[12]; // U3
-                    uLine[x / 2 + 4] = src[16]; // U4
-                    uLine[x / 2 + 5] = src[20]; // U5
-                    uLine[x / 2 + 6] = src[24]; // U6
-                    uLine[x / 2 + 7] = src[28]; // U7
-
-                    // Extract V values (8 UV pairs)
-                    vLine[x / 2] = src[2];      // V0
-                    vLine[x / 2 + 1] = src[6];  // V1
-                    vLine[x / 2 + 2] = src[10]; // V2
-                    vLine[x / 2 + 3] = src[14]; // V3
-                    vLine[x / 2 + 4] = src[18]; // V4
-                    vLine[x / 2 + 5] = src[22]; // V5
-                    vLine[x / 2 + 6] = src[26]; // V6
-                    vLine[x / 2 + 7] = src[30]; // V7
-                }
+int64_t VideoDecoder::rescalePts(int64_t rawPts) const {
+    if (!m_needsTimebaseConversion || rawPts == AV_NOPTS_VALUE) {
+        return rawPts;
+    }
 
-                // Handle remaining pixels in 8-pixel chunks
-                for (; x <= width - 8; x += 8) {
-                    const uint8_t* src = srcLine + x * 2;
-
-                    // Extract Y values (8 pixels)
-                    yLine[x] = src[1];      // Y0
-                    yLine[x + 1] = src[3];  // Y1
-                    yLine[x + 2] = src[5];  // Y2
-                    yLine[x + 3] = src[7];  // Y3
-                    yLine[x + 4] = src[9];  // Y4
-                    yLine[x + 5] = src[11]; // Y5
-                    yLine[x + 6] = src[13]; // Y6
-                    yLine[x + 7] = src[15]; // Y7
-
-                    // Extract U values (4 UV pairs)
-                    uLine[x / 2] = src[0];      // U0
-                    uLine[x / 2 + 1] = src[4];  // U1
-                    uLine[x / 2 + 2] = src[8];  // U2
-                    uLine[x / 2 + 3] = src[12]; // U3
-
-                    // Extract V values (4 UV pairs)
-                    vLine[x / 2] = src[2];      // V0
-                    vLine[x / 2 + 1] = src[6];  // V1
-                    vLine[x / 2 + 2] = src[10]; // V2
-                    vLine[x / 2 + 3] = src[14]; // V3
-                }
+    AVStream* videoStream = formatContext->streams[videoStreamIndex];
+    double frame_time = av_q2d(videoStream->time_base) * rawPts;
+    return llrint(frame_time * m_framerate);
+}
 
-                // Handle remaining pixels
-                for (; x < width; x += 2) {
-                    const uint8_t* src = srcLine + x * 2;
-                    yLine[x] = src[1]; // Y0
-                    if (x + 1 < width) {
-                        yLine[x + 1] = src[3]; // Y1
-                    }
-                    uLine[x / 2] = src[0]; // U0
-                    vLine[x / 2] = src[2]; // V0
-                }
+int64_t VideoDecoder::loadYUVFrame(bool wait) {
+    const uint8_t* frameBytes =
+        m_isStream ? m_streamReader.frame(currentFrameIndex, wait) : m_rawReader.frame(currentFrameIndex);
+    if (!frameBytes) {
+        // Once a stream ends its length is known, seeks and end frames then behave like a file
+        if (m_isStream && m_streamReader.atEnd() && yuvTotalFrames < 0) {
+            yuvTotalFrames = static_cast<int>(m_streamReader.framesRead());
+        }
+        return -1;
+    }
+
+    int64_t pts = currentFrameIndex;
+    FrameData* frameData = m_frameQueue->getTailFrame(pts);
+    if (!copyFrame(frameBytes, frameData)) {
+        frameData->setPts(-1);
+        return -1;
+    }
+    return pts;
+}
+
+/**
+ * @brief Pulls the next decoded frame, feeding packets to the decoder as needed.
+ *
+ * Pending output is always drained before another packet is sent, so the output delay of
+ * frame-threaded decoding never makes avcodec_send_packet() fail with EAGAIN. During a seek
+ * pre-roll, non-reference frames shown before the target are dropped by the decoder.
+ *
+ * @return 0 when a frame was received, AVERROR_EOF once the stream is drained, or another error.
+ */
+int VideoDecoder::decodeNextFrame(AVPacket* packet, AVFrame* frame) {
+    if (m_hasPendingFrame) {
+        av_frame_move_ref(frame, m_pendingFrame);
+        m_hasPendingFrame = false;
+        return 0;
+    }
+
+    while (true) {
+        int ret = avcodec_receive_frame(codecContext, frame);
+        if (ret != AVERROR(EAGAIN)) {
+            return ret;
+        }
+
+        ret = m_packetQueue.pop(packet);
+        if (ret < 0) {
+            if (ret != AVERROR_EOF) {
+                ErrorReporter::instance().report("Failed to read frame", LogLevel::Error);
             }
+            // Enter draining mode so frames still held by the decoder threads are returned
+            ret = avcodec_send_packet(codecContext, nullptr);
+            if (ret < 0) {
+                return ret;
+            }
+            continue;
+        }
 
-        } else if (srcFmt == AV_PIX_FMT_YUYV422) {
-            // YUYV: Y0 U0 Y1 V0 (4 bytes for 2 pixels)
-            debug("vd", "Converting YUYV422 to YUV422P...");
+        if (m_preRollTarget >= 0) {
+            // Nothing references a non-reference frame, one shown before the target is never needed.
+            // Packets without a timestamp and the last stretch from the target on decode fully.
+            int64_t pts = packet->pts;
+            bool beforeTarget =
+                pts != AV_NOPTS_VALUE && rescalePts(pts) - std::max<int64_t>(m_ptsOffset, 0) < m_preRollTarget;
+            codecContext->skip_frame = beforeTarget ? AVDISCARD_NONREF : AVDISCARD_DEFAULT;
+        }
 
-            const int uvWidth = width / 2;
+        ret = avcodec_send_packet(codecContext, packet);
+        if (ret < 0) {
+            warning("vd", "Failed to send packet to decoder, skipping it");
+        }
+        av_packet_unref(packet);
+    }
+}
 
-            // Optimized conversion with better memory access patterns
-            for (int y = 0; y < height; y++) {
-                const uint8_t* srcLine = packetData + y * width * 2;
-                uint8_t* yLine = yPtr + y * width;
-                uint8_t* uLine = uPtr + y * uvWidth;
-                uint8_t* vLine = vPtr + y * uvWidth;
-
-                int x = 0;
-                for (; x <= width - 16; x += 16) {
-                    const uint8_t* src = srcLine + x * 2;
-
-                    // Extract Y values (16 pixels) - unrolled for better performance
-                    yLine[x] = src[0];       // Y0
-                    yLine[x + 1] = src[2];   // Y1
-                    yLine[x + 2] = src[4];   // Y2
-                    yLine[x + 3] = src[6];   // Y3
-                    yLine[x + 4] = src[8];   // Y4
-                    yLine[x + 5] = src[10];  // Y5
-                    yLine[x + 6] = src[12];  // Y6
-                    yLine[x + 7] = src[14];  // Y7
-                    yLine[x + 8] = src[16];  // Y8
-                    yLine[x + 9] = src[18];  // Y9
-                    yLine[x + 10] = src[20]; // Y10
-                    yLine[x + 11] = src[22]; // Y11
-                    yLine[x + 12] = src[24]; // Y12
-                    yLine[x + 13] = src[26]; // Y13
-                    yLine[x + 14] = src[28]; // Y14
-                    yLine[x + 15] = src[30]; // Y15
-
-                    // Extract U values (8 UV pairs)
-                    uLine[x / 2] = src[1];      // U0
-                    uLine[x / 2 + 1] = src[5];  // U1
-                    uLine[x / 2 + 2] = src[9];  // U2
-                    uLine[x / 2 + 3] = src[13]; // U3
-                    uLine[x / 2 + 4] = src[17]; // U4
-                    uLine[x / 2 + 5] = src[21]; // U5
-                    uLine[x / 2 + 6] = src[25]; // U6
-                    uLine[x / 2 + 7] = src[29]; // U7
-
-                    // Extract V values (8 UV pairs)
-                    vLine[x / 2] = src[3];      // V0
-                    vLine[x / 2 + 1] = src[7];  // V1
-                    vLine[x / 2 + 2] = src[11]; // V2
-                    vLine[x / 2 + 3] = src[15]; // V3
-                    vLine[x / 2 + 4] = src[19]; // V4
-                    vLine[x / 2 + 5] = src[23]; // V5
-                    vLine[x / 2 + 6] = src[27]; // V6
-                    vLine[x / 2 + 7] = src[31]; // V7
-                }
+int64_t VideoDecoder::frameTimestamp(const AVFrame* frame) const {
+    return frame->pts != AV_NOPTS_VALUE ? frame->pts : frame->best_effort_timestamp;
+}
 
-                // Handle remaining pixels in 8-pixel chunks
-                for (; x <= width - 8; x += 8) {
-                    const uint8_t* src = srcLine + x * 2;
-
-                    // Extract Y values (8 pixels)
-                    yLine[x] = src[0];      // Y0
-                    yLine[x + 1] = src[2];  // Y1
-                    yLine[x + 2] = src[4];  // Y2
-                    yLine[x + 3] = src[6];  // Y3
-                    yLine[x + 4] = src[8];  // Y4
-                    yLine[x + 5] = src[10]; // Y5
-                    yLine[x + 6] = src[12]; // Y6
-                    yLine[x + 7] = src[14]; // Y7
-
-                    // Extract U values (4 UV pairs)
-                    uLine[x / 2] = src[1];      // U0
-                    uLine[x / 2 + 1] = src[5];  // U1
-                    uLine[x / 2 + 2] = src[9];  // U2
-                    uLine[x / 2 + 3] = src[13]; // U3
-
-                    // Extract V values (4 UV pairs)
-                    vLine[x / 2] = src[3];      // V0
-                    vLine[x / 2 + 1] = src[7];  // V1
-                    vLine[x / 2 + 2] = src[11]; // V2
-                    vLine[x / 2 + 3] = src[15]; // V3
-                }
+int64_t VideoDecoder::loadCompressedFrame() {
+    int ret = decodeNextFrame(m_packet, m_frame);
+    if (ret < 0) {
+        if (ret != AVERROR_EOF) {
+            ErrorReporter::instance().report("Failed to decode frame", LogLevel::Error);
+        }
+        return -1;
+    }
 
-                // Handle remaining pixels
-                for (; x < width; x += 2) {
-                    const uint8_t* src = srcLine + x * 2;
-                    yLine[x] = src[0]; // Y0
-                    if (x + 1 < width) {
-                        yLine[x + 1] = src[2]; // Y1
-                    }
-                    uLine[x / 2] = src[1]; // U0
-                    vLine[x / 2] = src[3]; // V0
-                }
+    int64_t raw_pts = frameTimestamp(m_frame);
+    int64_t normalized_pts = rescalePts(raw_pts);
+
+    // Streams without a start time count from the first frame decoded
+    if (m_ptsOffset == -1 && normalized_pts >= 0) {
+        m_ptsOffset = normalized_pts;
+    }
+
+    normalized_pts -= m_ptsOffset;
+
+    // A frame decoded into its slot is published there, unless its pts turned out different than
+    // the one the slot was claimed for
+    int64_t claimedPts = -1;
+    FrameData* directSlot = takeDirectSlot(m_frame, &claimedPts);
+    FrameData* frameData =
+        directSlot && claimedPts == normalized_pts ? directSlot : m_frameQueue->getTailFrame(normalized_pts);
+    bool converted = writeFrame(m_frame, frameData);
+    av_frame_unref(m_frame);
+    if (directSlot && directSlot != frameData) {
+        directSlot->setPts(-1);
+    }
+
+    if (!converted) {
+        // The frame is skipped instead of ending the batch, which reports the failure. Reopening the
+        // file asks the demuxer for 4:2:0 output, the queue keeps the layout it was built with.
+        frameData->setPts(-1);
+        m_batchFailed = true;
+        setFormat(AV_PIX_FMT_YUV420P);
+        currentFrameIndex = normalized_pts + 1;
+        return kFrameFailed;
+    }
+
+    // Publishing the normalized pts makes the frame visible to readers
+    frameData->setEndFrame(false);
+    frameData->setPts(normalized_pts);
+    currentFrameIndex = normalized_pts + 1;
+
+    if (DebugManager::instance().isEnabled(QStringLiteral("vd"))) {
+        debug("vd",
+              QString("loadCompressedFrame loaded frame %1 from raw PTS %2 at queue index %3")
+                  .arg(normalized_pts)
+                  .arg(raw_pts)
+                  .arg(normalized_pts));
+    }
+
+    return normalized_pts;
+}
+
+/**
+ * @brief Converts a decoded frame into a FrameQueue slot.
+ *
+ * Hardware frames are transferred to system memory first. Frames already decoded into the slot
+ * by getDirectBuffer() are left untouched. While a proxy shift is set, the frame is downscaled
+ * into the top left of each slot plane instead, keeping the slot strides.
+ *
+ * @return false if the frame could not be transferred or converted.
+ */
+bool VideoDecoder::writeFrame(AVFrame* frame, FrameData* frameData) {
+    // Planar 8 bit frames keep their layout, anything else was announced as 4:2:0 in the metadata
+    AVPixelFormat dstFormat = metadata.format();
+
+    // Hardware frame transfer if needed
+    AVFrame* outputFrame = frame;
+    if (hw_device_ctx && frame->format == hw_pix_fmt) {
+        // The transfer buffers are kept across frames, they are only reallocated when the surfaces change
+        outputFrame = m_transferFrame;
+        const AVHWFramesContext* frames = reinterpret_cast<const AVHWFramesContext*>(frame->hw_frames_ctx->data);
+        if (outputFrame->buf[0] && (outputFrame->width != frame->width || outputFrame->height != frame->height ||
+                                    outputFrame->format != frames->sw_format)) {
+            av_frame_unref(outputFrame);
+        }
+        if (av_hwframe_transfer_data(outputFrame, frame, 0) < 0) {
+            ErrorReporter::instance().report("Failed to transfer frame from GPU to CPU", LogLevel::Error);
+            av_frame_unref(outputFrame);
+            return false;
+        }
+    }
+
+    // Frames decoded into the slot by getDirectBuffer() are always full resolution
+    bool direct = outputFrame->data[0] == frameData->yPtr();
+    int shift = direct ? 0 : m_proxyShift.load(std::memory_order_relaxed);
+    int width = AV_CEIL_RSHIFT(metadata.yWidth(), shift);
+    int height = AV_CEIL_RSHIFT(metadata.yHeight(), shift);
+
+    uint8_t* dstData[4] = {frameData->yPtr(), frameData->uPtr(), frameData->vPtr(), nullptr};
+    int dstLinesize[4] = {frameData->yStride(), frameData->uvStride(), frameData->uvStride(), 0};
+
+    bool converted = false;
+    if (direct) {
+        converted = true;
+    } else if (outputFrame->format == dstFormat && outputFrame->width == width && outputFrame->height == height) {
+        // Already in the target layout, only the line padding has to be dropped
+        av_image_copy(dstData,
+                      dstLinesize,
+                      (const uint8_t**)outputFrame->data,
+                      outputFrame->linesize,
+                      dstFormat,
+                      width,
+                      height);
+        converted = true;
+    } else {
+        // Reuse the scaler across frames, it is only rebuilt when the source or the proxy size changes
+        m_swsContext = sws_getCachedContext(m_swsContext,
+                                            outputFrame->width,
+                                            outputFrame->height,
+                                            (AVPixelFormat)outputFrame->format,
+                                            width,
+                                            height,
+                                            dstFormat,
+                                            shift > 0 ? SWS_FAST_BILINEAR : SWS_BILINEAR,
+                                            nullptr,
+                                            nullptr,
+                                            nullptr);
+        if (m_swsContext) {
+            sws_scale(m_swsContext,
+                      (const uint8_t* const*)outputFrame->data,
+                      outputFrame->linesize,
+                      0,
+                      outputFrame->height,
+                      dstData,
+                      dstLinesize);
+            converted = true;
+        }
+    }
+    frameData->setProxyShift(shift);
+
+    if (!converted) {
+        ErrorReporter::instance().report("Failed to create swsContext for YUV conversion", LogLevel::Error);
+    }
+    return converted;
+}
+
+/**
+ * @brief Serves a backward batch from the GOP cache, decoding the GOP once if frames are missing.
+ *
+ * Frames are handed to the queue from the highest PTS down, the way they are played.
+ *
+ * @return Highest PTS written to the queue, -1 if none.
+ */
+int64_t VideoDecoder::loadReverseFrames(int64_t first, int64_t last) {
+    for (int64_t pts = first; pts <= last; ++pts) {
+        if (m_reverseCache.find(pts) == m_reverseCache.end()) {
+            fillReverseCache(first, last);
+            break;
+        }
+    }
+
+    int64_t maxpts = -1;
+    int totalFrames = getTotalFrames();
+    for (int64_t pts = last; pts >= first; --pts) {
+        auto it = m_reverseCache.find(pts);
+        if (it == m_reverseCache.end()) {
+            continue;
+        }
+
+        FrameData* frameData = m_frameQueue->getTailFrame(pts);
+        bool written = writeFrame(it->second, frameData);
+        dropReverseFrame(it);
+        if (!written) {
+            frameData->setPts(-1);
+            continue;
+        }
+
+        frameData->setEndFrame(totalFrames > 0 && pts >= totalFrames - 1);
+        frameData->setPts(pts);
+        maxpts = std::max(maxpts, pts);
+    }
+
+    // Loads continue after the batch as if it had been decoded forward
+    currentFrameIndex = last + 1;
+    m_reverseResync = true;
+
+    debug("vd",
+          QString("Reverse batch %1 to %2 served, %3 frames left in GOP cache")
+              .arg(first)
+              .arg(last)
+              .arg(m_reverseCache.size()));
+    return maxpts;
+}
+
+/**
+ * @brief Decodes from the keyframe before first up to last, keeping every frame of the GOP.
+ *
+ * Frames ahead of the batch stay cached for the following backward batches. When the cache is
+ * full the lowest PTS go first, they are the furthest away from being played.
+ */
+void VideoDecoder::fillReverseCache(int64_t first, int64_t last) {
+    if (!seekDemuxer(first)) {
+        return;
+    }
+
+    // The cache may take a video's share of the budget, with a fixed queue size as much memory as the queue
+    size_t capacity = reverseCacheCapacity(first, last);
+    int64_t budget = AppConfig::instance().getCacheBudget() > 0
+                         ? FrameArena::instance().fairShare()
+                         : static_cast<int64_t>(m_frameQueue->getSize()) * m_frameQueue->slotBytes();
+    while (decodeNextFrame(m_packet, m_frame) >= 0) {
+        int64_t pts = rescalePts(frameTimestamp(m_frame)) - std::max<int64_t>(m_ptsOffset, 0);
+        if (pts > last) {
+            av_frame_unref(m_frame);
+            break;
+        }
+
+        // Hardware surfaces come from a small pool, keep system memory copies instead
+        AVFrame* cached = av_frame_alloc();
+        if (hw_device_ctx && m_frame->format == hw_pix_fmt) {
+            if (!cached || av_hwframe_transfer_data(cached, m_frame, 0) < 0) {
+                av_frame_free(&cached);
             }
+        } else if (cached) {
+            av_frame_move_ref(cached, m_frame);
         }
+        av_frame_unref(m_frame);
 
-        // Update metadata to reflect the converted planar format
-        if (srcFmt == AV_PIX_FMT_UYVY422 || srcFmt == AV_PIX_FMT_YUYV422) {
-            metadata.setPixelFormat(AV_PIX_FMT_YUV422P);
-            setFormat(AV_PIX_FMT_YUV422P);
+        if (!cached || pts < 0) {
+            av_frame_free(&cached);
+            continue;
+        }
+        cacheReverseFrame(pts, cached);
+
+        // The frame just decoded is kept even when it alone exceeds the budget
+        while (m_reverseCache.size() > capacity || (m_reverseCache.size() > 1 && m_reverseCacheBytes > budget)) {
+            dropReverseFrame(m_reverseCache.begin());
+        }
+    }
+}
+
+/**
+ * @brief Frames from the keyframe before first up to last, the whole stretch fillReverseCache() decodes.
+ *
+ * Holding all of them lets every backward batch down to the keyframe be served from one decode of the
+ * GOP. Until the keyframe index is ready the queue size is used.
+ */
+size_t VideoDecoder::reverseCacheCapacity(int64_t first, int64_t last) const {
+    KeyframeIndex::Entry keyframe;
+    if (!m_keyframeIndex->keyframeBefore(toStreamTimestamp(first), keyframe)) {
+        return static_cast<size_t>(std::max(m_frameQueue->getSize(), 1));
+    }
+    int64_t keyframeTs = keyframe.pts != AV_NOPTS_VALUE ? keyframe.pts : keyframe.dts;
+    int64_t keyframePts = std::clamp<int64_t>(rescalePts(keyframeTs) - std::max<int64_t>(m_ptsOffset, 0), 0, first);
+    return static_cast<size_t>(last - keyframePts + 1);
+}
+
+void VideoDecoder::cacheReverseFrame(int64_t pts, AVFrame* frame) {
+    auto it = m_reverseCache.find(pts);
+    if (it != m_reverseCache.end()) {
+        dropReverseFrame(it);
+    }
+    m_reverseCache.emplace(pts, frame);
+    int64_t bytes = frameBytes(frame);
+    m_reverseCacheBytes += bytes;
+    FrameArena::instance().charge(bytes);
+}
+
+void VideoDecoder::dropReverseFrame(std::map<int64_t, AVFrame*>::iterator it) {
+    int64_t bytes = frameBytes(it->second);
+    m_reverseCacheBytes -= bytes;
+    FrameArena::instance().uncharge(bytes);
+    av_frame_free(&it->second);
+    m_reverseCache.erase(it);
+}
+
+void VideoDecoder::clearReverseCache() {
+    while (!m_reverseCache.empty()) {
+        dropReverseFrame(m_reverseCache.begin());
+    }
+}
+
+/**
+ * @brief Copies a raw YUV frame into the provided FrameData structure.
+ *
+ * This function handles the copying of raw YUV frame data while preserving the original format
+ * and populates the FrameData structure with the Y, U, and V plane pointers.
+ *
+ * @param packetData Pointer to the raw frame bytes.
+ * @param frameData Pointer to the FrameData structure to populate.
+ * @return false if the frame could not be copied.
+ */
+bool VideoDecoder::copyFrame(const uint8_t* packetData, FrameData* frameData) {
+    AVPixelFormat srcFmt = m_rawFormat;
+    int width = metadata.yWidth();
+    int height = metadata.yHeight();
+
+    const AVPixFmtDescriptor* pixDesc = av_pix_fmt_desc_get(srcFmt);
+    if (!pixDesc) {
+        ErrorReporter::instance().report("Failed to get pixel format descriptor", LogLevel::Error);
+        return false;
+    }
+
+    // Handle packed YUV formats differently
+    if (isPackedYUV(srcFmt)) {
+        if (DebugManager::instance().isEnabled(QStringLiteral("vd"))) {
+            debug("vd",
+                  QString("Processing packed YUV format: %1 Dimensions: %2x%3 Packet size: %4")
+                      .arg(av_get_pix_fmt_name(srcFmt))
+                      .arg(width)
+                      .arg(height)
+                      .arg(m_rawReader.frameSize()));
         }
-    } else if (isSemiPlanarYUV(srcFmt)) {
-        debug("vd",
-              QString("Processing semi-planar YUV format: %1 Dimensions: %2x%3 Packet size: %4")
-                  .arg(av_get_pix_fmt_name(srcFmt))
-                  .arg(width)
-                  .arg(height)
-                  .arg(tempPacket->size));
 
         uint8_t* yPtr = frameData->yPtr();
         uint8_t* uPtr = frameData->uPtr();
@@ -985,210 +1505,55 @@ void VideoDecoder::copyFrame(AVPacket*& tempPacket, FrameData* frameData, int& r
         // Verify pointers are valid
         if (!yPtr || !uPtr || !vPtr) {
             ErrorReporter::instance().report("Invalid frame data pointers", LogLevel::Error);
-            retFlag = 2;
-            return;
+            return false;
         }
 
-        // Copy Y plane (first plane)
-        int ySize = width * height;
-        memcpy(yPtr, packetData, ySize);
-
-        // Process UV interleaved plane (second plane)
-        uint8_t* uvData = packetData + ySize;
-        int uvWidth = width / 2;
-        int uvHeight = height / 2;
-
-        if (srcFmt == AV_PIX_FMT_NV12) {
-            // NV12: Y plane + UV interleaved plane
-            debug("vd", "Converting NV12 to YUV420P...");
-
-            // Optimized conversion with better memory access patterns
-            for (int y = 0; y < uvHeight; y++) {
-                const uint8_t* uvLine = uvData + y * width;
-                uint8_t* uLine = uPtr + y * uvWidth;
-                uint8_t* vLine = vPtr + y * uvWidth;
-
-                int x = 0;
-                for (; x <= uvWidth - 16; x += 16) {
-                    const uint8_t* src = uvLine + x * 2;
-
-                    // Extract U values (16 UV pairs) - unrolled for better performance
-                    uLine[x] = src[0];       // U0
-                    uLine[x + 1] = src[2];   // U1
-                    uLine[x + 2] = src[4];   // U2
-                    uLine[x + 3] = src[6];   // U3
-                    uLine[x + 4] = src[8];   // U4
-                    uLine[x + 5] = src[10];  // U5
-                    uLine[x + 6] = src[12];  // U6
-                    uLine[x + 7] = src[14];  // U7
-                    uLine[x + 8] = src[16];  // U8
-                    uLine[x + 9] = src[18];  // U9
-                    uLine[x + 10] = src[20]; // U10
-                    uLine[x + 11] = src[22]; // U11
-                    uLine[x + 12] = src[24]; // U12
-                    uLine[x + 13] = src[26]; // U13
-                    uLine[x + 14] = src[28]; // U14
-                    uLine[x + 15] = src[30]; // U15
-
-                    // Extract V values (16 UV pairs)
-                    vLine[x] = src[1];       // V0
-                    vLine[x + 1] = src[3];   // V1
-                    vLine[x + 2] = src[5];   // V2
-                    vLine[x + 3] = src[7];   // V3
-                    vLine[x + 4] = src[9];   // V4
-                    vLine[x + 5] = src[11];  // V5
-                    vLine[x + 6] = src[13];  // V6
-                    vLine[x + 7] = src[15];  // V7
-                    vLine[x + 8] = src[17];  // V8
-                    vLine[x + 9] = src[19];  // V9
-                    vLine[x + 10] = src[21]; // V10
-                    vLine[x + 11] = src[23]; // V11
-                    vLine[x + 12] = src[25]; // V12
-                    vLine[x + 13] = src[27]; // V13
-                    vLine[x + 14] = src[29]; // V14
-                    vLine[x + 15] = src[31]; // V15
-                }
-
-                // Handle remaining pixels in 8-pixel chunks
-                for (; x <= uvWidth - 8; x += 8) {
-                    const uint8_t* src = uvLine + x * 2;
-
-                    // Extract U values (8 UV pairs)
-                    uLine[x] = src[0];      // U0
-                    uLine[x + 1] = src[2];  // U1
-                    uLine[x + 2] = src[4];  // U2
-                    uLine[x + 3] = src[6];  // U3
-                    uLine[x + 4] = src[8];  // U4
-                    uLine[x + 5] = src[10]; // U5
-                    uLine[x + 6] = src[12]; // U6
-                    uLine[x + 7] = src[14]; // U7
-
-                    // Extract V values (8 UV pairs)
-                    vLine[x] = src[1];      // V0
-                    vLine[x + 1] = src[3];  // V1
-                    vLine[x + 2] = src[5];  // V2
-                    vLine[x + 3] = src[7];  // V3
-                    vLine[x + 4] = src[9];  // V4
-                    vLine[x + 5] = src[11]; // V5
-                    vLine[x + 6] = src[13]; // V6
-                    vLine[x + 7] = src[15]; // V7
-                }
+        if (m_gpuUnpack) {
+            // Stored as-is, the whole packed frame lives in the Y plane
+            copyToSlot(packetData, frameData, metadata);
+        } else {
+            // Convert packed YUV to planar YUV422P for internal processing
+            const PixelKernels::Kernels& kernels = PixelKernels::best();
+            PixelKernels::PackedToPlanarRow convertRow =
+                srcFmt == AV_PIX_FMT_UYVY422 ? kernels.uyvyToPlanar : kernels.yuyvToPlanar;
 
-                // Handle remaining UV pairs
-                for (; x < uvWidth; x++) {
-                    const uint8_t* src = uvLine + x * 2;
-                    uLine[x] = src[0]; // U component
-                    vLine[x] = src[1]; // V component
-                }
+            const int yStride = frameData->yStride();
+            const int uvStride = frameData->uvStride();
+            for (int y = 0; y < height; y++) {
+                convertRow(packetData + y * width * 2,
+                           yPtr + y * yStride,
+                           uPtr + y * uvStride,
+                           vPtr + y * uvStride,
+                           width);
             }
-        } else if (srcFmt == AV_PIX_FMT_NV21) {
-            // NV21: Y plane + VU interleaved plane
-            debug("vd", "Converting NV21 to YUV420P...");
-
-            // Optimized conversion with better memory access patterns
-            for (int y = 0; y < uvHeight; y++) {
-                const uint8_t* vuLine = uvData + y * width;
-                uint8_t* uLine = uPtr + y * uvWidth;
-                uint8_t* vLine = vPtr + y * uvWidth;
-
-                int x = 0;
-                for (; x <= uvWidth - 16; x += 16) {
-                    const uint8_t* src = vuLine + x * 2;
-
-                    // Extract V values (16 VU pairs) - unrolled for better performance
-                    vLine[x] = src[0];       // V0
-                    vLine[x + 1] = src[2];   // V1
-                    vLine[x + 2] = src[4];   // V2
-                    vLine[x + 3] = src[6];   // V3
-                    vLine[x + 4] = src[8];   // V4
-                    vLine[x + 5] = src[10];  // V5
-                    vLine[x + 6] = src[12];  // V6
-                    vLine[x + 7] = src[14];  // V7
-                    vLine[x + 8] = src[16];  // V8
-                    vLine[x + 9] = src[18];  // V9
-                    vLine[x + 10] = src[20]; // V10
-                    vLine[x + 11] = src[22]; // V11
-                    vLine[x + 12] = src[24]; // V12
-                    vLine[x + 13] = src[26]; // V13
-                    vLine[x + 14] = src[28]; // V14
-                    vLine[x + 15] = src[30]; // V15
-
-                    // Extract U values (16 VU pairs)
-                    uLine[x] = src[1];       // U0
-                    uLine[x + 1] = src[3];   // U1
-                    uLine[x + 2] = src[5];   // U2
-                    uLine[x + 3] = src[7];   // U3
-                    uLine[x + 4] = src[9];   // U4
-                    uLine[x + 5] = src[11];  // U5
-                    uLine[x + 6] = src[13];  // U6
-                    uLine[x + 7] = src[15];  // U7
-                    uLine[x + 8] = src[17];  // U8
-                    uLine[x + 9] = src[19];  // U9
-                    uLine[x + 10] = src[21]; // U10
-                    uLine[x + 11] = src[23]; // U11
-                    uLine[x + 12] = src[25]; // U12
-                    uLine[x + 13] = src[27]; // U13
-                    uLine[x + 14] = src[29]; // U14
-                    uLine[x + 15] = src[31]; // U15
-                }
+        }
+    } else if (isSemiPlanarYUV(srcFmt)) {
+        if (DebugManager::instance().isEnabled(QStringLiteral("vd"))) {
+            debug("vd",
+                  QString("Processing semi-planar YUV format: %1 Dimensions: %2x%3 Packet size: %4")
+                      .arg(av_get_pix_fmt_name(srcFmt))
+                      .arg(width)
+                      .arg(height)
+                      .arg(m_rawReader.frameSize()));
+        }
 
-                // Handle remaining pixels in 8-pixel chunks
-                for (; x <= uvWidth - 8; x += 8) {
-                    const uint8_t* src = vuLine + x * 2;
-
-                    // Extract V values (8 VU pairs)
-                    vLine[x] = src[0];      // V0
-                    vLine[x + 1] = src[2];  // V1
-                    vLine[x + 2] = src[4];  // V2
-                    vLine[x + 3] = src[6];  // V3
-                    vLine[x + 4] = src[8];  // V4
-                    vLine[x + 5] = src[10]; // V5
-                    vLine[x + 6] = src[12]; // V6
-                    vLine[x + 7] = src[14]; // V7
-
-                    // Extract U values (8 VU pairs)
-                    uLine[x] = src[1];      // U0
-                    uLine[x + 1] = src[3];  // U1
-                    uLine[x + 2] = src[5];  // U2
-                    uLine[x + 3] = src[7];  // U3
-                    uLine[x + 4] = src[9];  // U4
-                    uLine[x + 5] = src[11]; // U5
-                    uLine[x + 6] = src[13]; // U6
-                    uLine[x + 7] = src[15]; // U7
-                }
+        uint8_t* yPtr = frameData->yPtr();
+        uint8_t* uvPtr = frameData->uPtr();
 
-                // Handle remaining VU pairs
-                for (; x < uvWidth; x++) {
-                    const uint8_t* src = vuLine + x * 2;
-                    vLine[x] = src[0]; // V component
-                    uLine[x] = src[1]; // U component
-                }
-            }
+        // Verify pointers are valid
+        if (!yPtr || !uvPtr) {
+            ErrorReporter::instance().report("Invalid frame data pointers", LogLevel::Error);
+            return false;
         }
 
-        // Update metadata to reflect the converted planar format
-        if (srcFmt == AV_PIX_FMT_NV12 || srcFmt == AV_PIX_FMT_NV21) {
-            metadata.setPixelFormat(AV_PIX_FMT_YUV420P);
-            setFormat(AV_PIX_FMT_YUV420P);
-        }
+        // The UV (NV12) or VU (NV21) plane stays interleaved, the renderer samples it as one texture
+        copyToSlot(packetData, frameData, metadata);
     } else {
-        // Handle planar YUV formats
-        int uvWidth = AV_CEIL_RSHIFT(width, pixDesc->log2_chroma_w);
-        int uvHeight = AV_CEIL_RSHIFT(height, pixDesc->log2_chroma_h);
-
-        uint8_t* srcData[4] = {nullptr};
-        int srcLinesize[4] = {};
-        av_image_fill_arrays(srcData, srcLinesize, packetData, srcFmt, width, height, 1);
-        uint8_t* dstData[4] = {frameData->yPtr(), frameData->uPtr(), frameData->vPtr(), nullptr};
-
-        memcpy(dstData[0], srcData[0], width * height);
-        memcpy(dstData[1], srcData[1], uvWidth * uvHeight);
-        memcpy(dstData[2], srcData[2], uvWidth * uvHeight);
+        // Planar YUV formats
+        copyToSlot(packetData, frameData, metadata);
     }
 
-    frameData->setPts(currentFrameIndex);
-
-    if (!m_isY4M && codecContext && isYUV(codecContext->codec_id)) {
+    if (m_isRawYUV) {
         if (currentFrameIndex == yuvTotalFrames - 1) {
             debug("vd", QString("%1 is end frame").arg(currentFrameIndex));
             frameData->setEndFrame(true);
@@ -1199,7 +1564,11 @@ void VideoDecoder::copyFrame(AVPacket*& tempPacket, FrameData* frameData, int& r
         }
     }
 
+    // Published last, readers see the end flag together with the frame
+    frameData->setPts(currentFrameIndex);
+
     currentFrameIndex++;
+    return true;
 }
 
 int VideoDecoder::getTotalFrames() {
@@ -1207,7 +1576,7 @@ int VideoDecoder::getTotalFrames() {
         return yuvTotalFrames;
     }
 
-    if (!m_isY4M && codecContext && isYUV(codecContext->codec_id) && yuvTotalFrames > 0) {
+    if (m_isRawYUV && yuvTotalFrames > 0) {
         return yuvTotalFrames;
     }
 
@@ -1221,7 +1590,8 @@ int VideoDecoder::getTotalFrames() {
         return static_cast<int>(videoStream->nb_frames);
     }
 
-    return -1;
+    // Counted by an earlier keyframe index build when the container does not say
+    return m_indexedTotalFrames > 0 ? m_indexedTotalFrames : -1;
 }
 
 int64_t VideoDecoder::getDurationMs() {
@@ -1230,6 +1600,10 @@ int64_t VideoDecoder::getDurationMs() {
         return static_cast<int64_t>((yuvTotalFrames / m_y4mInfo.frameRate) * 1000.0);
     }
 
+    if (m_isRawYUV && yuvTotalFrames > 0 && m_framerate > 0) {
+        return static_cast<int64_t>((yuvTotalFrames / m_framerate) * 1000.0);
+    }
+
     if (!formatContext || videoStreamIndex < 0) {
         return -1;
     }
@@ -1262,155 +1636,132 @@ void VideoDecoder::seekTo(int64_t targetPts) {
 
     if (m_isY4M) {
         seekToY4M(targetPts);
+    } else if (m_isRawYUV) {
+        seekToYUV(targetPts);
     } else if (!formatContext || !codecContext || videoStreamIndex < 0) {
         ErrorReporter::instance().report("VideoDecoder not properly initialized for seeking", LogLevel::Error);
         return;
-    } else if (isYUV(codecContext->codec_id)) {
-        seekToYUV(targetPts);
     } else {
         seekToCompressed(targetPts);
     }
 }
 
 void VideoDecoder::seekToYUV(int64_t targetPts) {
-    QFileInfo info(QString::fromStdString(m_fileName));
-    int64_t fileSize = info.size();
-
-    // Calculate frame size
-    const AVPixFmtDescriptor* pixDesc = av_pix_fmt_desc_get(codecContext->pix_fmt);
-    int uvWidth = AV_CEIL_RSHIFT(m_width, pixDesc->log2_chroma_w);
-    int uvHeight = AV_CEIL_RSHIFT(m_height, pixDesc->log2_chroma_h);
-    int ySize = m_width * m_height;
-    int uvSize = uvWidth * uvHeight;
-    int frameSize = ySize + 2 * uvSize;
+    if (!m_rawReader.isOpen() && !m_streamReader.isOpen()) {
+        ErrorReporter::instance().report("Raw YUV reader not properly initialized for seeking", LogLevel::Error);
+        return;
+    }
 
-    // Recalculate total frames based on actual file size
-    int64_t actualTotalFrames = fileSize / frameSize;
-    if (actualTotalFrames != yuvTotalFrames) {
-        warning("vd",
-                QString("YUV file size mismatch - calculated: %1 actual: %2 fileSize: %3 frameSize: %4")
-                    .arg(yuvTotalFrames)
-                    .arg(actualTotalFrames)
-                    .arg(fileSize)
-                    .arg(frameSize));
-        yuvTotalFrames = actualTotalFrames;
+    // Frames sit at fixed offsets in the mapping, seeking only moves the read index
+    if (yuvTotalFrames > 0 && targetPts >= yuvTotalFrames) {
+        targetPts = yuvTotalFrames - 1;
     }
 
-    // Calculate byte position for target frame
-    int64_t bytePosition = targetPts * frameSize;
+    currentFrameIndex = targetPts;
+    debug("vd", QString("Successfully seeked to frame %1").arg(targetPts));
+}
 
-    // First, try to seek to the beginning to ensure we have a clean state
-    int ret = avio_seek(formatContext->pb, 0, SEEK_SET);
-    if (ret < 0) {
-        char errBuf[AV_ERROR_MAX_STRING_SIZE];
-        av_strerror(ret, errBuf, AV_ERROR_MAX_STRING_SIZE);
-        ErrorReporter::instance().report("Failed to seek to beginning of YUV file (error: " + std::string(errBuf) + ")",
-                                         LogLevel::Error);
-        return;
+int64_t VideoDecoder::toStreamTimestamp(int64_t framePts) const {
+    // Frame indices are relative to the first frame, stream timestamps are not
+    int64_t streamPts = framePts + std::max<int64_t>(m_ptsOffset, 0);
+    if (!m_needsTimebaseConversion) {
+        return streamPts;
     }
+    AVStream* videoStream = formatContext->streams[videoStreamIndex];
+    return llrint(streamPts / m_framerate / av_q2d(videoStream->time_base));
+}
 
-    // Now seek to the calculated position
-    ret = avio_seek(formatContext->pb, bytePosition, SEEK_SET);
-    if (ret < 0) {
-        debug("vd", "Direct seek failed, trying alternative method");
-
-        // Try seeking from current position
-        int64_t currentPos = avio_tell(formatContext->pb);
-        if (currentPos >= 0) {
-            int64_t offset = bytePosition - currentPos;
-            if (offset > 0) {
-                ret = avio_seek(formatContext->pb, offset, SEEK_CUR);
-            } else if (offset < 0) {
-                ret = avio_seek(formatContext->pb, -offset, SEEK_CUR);
-            } else {
-                ret = 0; // Already at correct position
-            }
-        }
-
-        if (ret < 0) {
-            char errBuf[AV_ERROR_MAX_STRING_SIZE];
-            av_strerror(ret, errBuf, AV_ERROR_MAX_STRING_SIZE);
-            ErrorReporter::instance().report("Failed to seek in YUV file to frame: " + std::to_string(targetPts) +
-                                                 " (error: " + std::string(errBuf) + ")",
-                                             LogLevel::Error);
-            return;
-        }
+/**
+ * @brief Whether decoding on from the current position reaches targetPts without a demuxer seek.
+ *
+ * Holds when the keyframe the target depends on is not ahead of the position: a seek would land
+ * at or before where the decoder already is and decode the same frames again.
+ */
+bool VideoDecoder::canWalkForward(int64_t targetPts) const {
+    if (m_reverseResync || !m_reverseCache.empty() || m_ptsOffset < 0 || targetPts < currentFrameIndex) {
+        return false;
+    }
+    if (targetPts == currentFrameIndex) {
+        return true;
     }
 
-    currentFrameIndex = targetPts;
-    debug("vd", QString("Successfully seeked to frame %1").arg(targetPts));
-    return;
+    KeyframeIndex::Entry keyframe;
+    if (!m_keyframeIndex->keyframeBefore(toStreamTimestamp(targetPts), keyframe)) {
+        return false;
+    }
+    int64_t keyframeTs = keyframe.pts != AV_NOPTS_VALUE ? keyframe.pts : keyframe.dts;
+    return keyframeTs <= toStreamTimestamp(currentFrameIndex);
 }
 
-void VideoDecoder::seekToCompressed(int64_t targetPts) {
-    int64_t seek_timestamp = targetPts;
+bool VideoDecoder::seekDemuxer(int64_t targetPts) {
+    int64_t seek_timestamp = toStreamTimestamp(targetPts);
     if (m_needsTimebaseConversion) {
-        AVStream* videoStream = formatContext->streams[videoStreamIndex];
-        double timestamp_seconds = targetPts / m_framerate;
-        seek_timestamp = llrint(timestamp_seconds / av_q2d(videoStream->time_base));
+        debug("vd", QString("Decoder::seekTo frame %1 -> stream_ts %2").arg(targetPts).arg(seek_timestamp));
+    }
 
-        debug("vd",
-              QString("Decoder::seekTo frame %1 -> time %2s -> stream_ts %3")
-                  .arg(targetPts)
-                  .arg(timestamp_seconds)
-                  .arg(seek_timestamp));
+    if (m_hasPendingFrame) {
+        av_frame_unref(m_pendingFrame);
+        m_hasPendingFrame = false;
     }
 
+    // Jump straight to the keyframe the target depends on, demuxers seek on decode timestamps
+    KeyframeIndex::Entry keyframe;
+    if (m_keyframeIndex->keyframeBefore(seek_timestamp, keyframe)) {
+        seek_timestamp = keyframe.dts != AV_NOPTS_VALUE ? keyframe.dts : keyframe.pts;
+        debug("vd", QString("Decoder::seekTo frame %1 -> keyframe at stream_ts %2").arg(targetPts).arg(seek_timestamp));
+    }
+
+    // The reader thread owns the demuxer while it runs, read-ahead packets are stale after the seek
+    m_packetQueue.stop();
     int ret = av_seek_frame(formatContext, videoStreamIndex, seek_timestamp, AVSEEK_FLAG_BACKWARD);
+    m_packetQueue.start(formatContext, videoStreamIndex);
 
     if (ret < 0) {
         ErrorReporter::instance().report("Failed to seek to timestamp: " + std::to_string(targetPts), LogLevel::Error);
-        return;
+        return false;
     }
 
     avcodec_flush_buffers(codecContext);
+    abandonDirectSlots();
+    m_reverseResync = false;
+    return true;
+}
 
-    int64_t current_pts = -1;
-    while (current_pts < targetPts - 1) {
-        // Decode frames until we reach the exact target PTS
-        AVPacket* packet = av_packet_alloc();
-        AVFrame* frame = av_frame_alloc();
-        if (!packet || !frame) {
-            ErrorReporter::instance().report("Failed to allocate packet or frame for seeking", LogLevel::Error);
-            if (packet)
-                av_packet_free(&packet);
-            if (frame)
-                av_frame_free(&frame);
-            return;
-        }
+void VideoDecoder::seekToCompressed(int64_t targetPts) {
+    if (canWalkForward(targetPts)) {
+        debug("vd",
+              QString("Decoding on from frame %1 to reach %2 without seeking").arg(currentFrameIndex).arg(targetPts));
+    } else if (!seekDemuxer(targetPts)) {
+        return;
+    }
+
+    // Frames decoded on the way to the target must not land in the queue
+    m_directMinPts = targetPts;
+    m_preRollTarget = targetPts;
 
-        int ret = av_read_frame(formatContext, packet);
+    // Decode up to the target and keep the first frame at or past it for the next load. Frames
+    // still queued inside the decoder threads come out in order, so nothing else is lost.
+    while (true) {
+        int ret = decodeNextFrame(m_packet, m_frame);
         if (ret < 0) {
             debug("vd", QString("seekTo reached EOF while seeking to frame %1").arg(targetPts));
             break;
         }
 
-        if (packet->stream_index == videoStreamIndex) {
-            ret = avcodec_send_packet(codecContext, packet);
-            if (ret < 0) {
-                warning("vd", "seekTo failed to send packet to decoder");
-                av_packet_free(&packet);
-                av_frame_free(&frame);
-                continue;
-            }
+        int64_t current_pts = rescalePts(frameTimestamp(m_frame)) - std::max<int64_t>(m_ptsOffset, 0);
+        debug("vd", QString("Decoder::seekTo decoded frame with PTS: %1 target: %2").arg(current_pts).arg(targetPts));
 
-            ret = avcodec_receive_frame(codecContext, frame);
-            if (ret == 0) {
-                current_pts = frame->pts;
-                if (m_needsTimebaseConversion && current_pts != AV_NOPTS_VALUE) {
-                    AVStream* videoStream = formatContext->streams[videoStreamIndex];
-                    AVRational targetTimebase = av_d2q(1.0 / m_framerate, 1000000);
-                    current_pts = av_rescale_q(current_pts, videoStream->time_base, targetTimebase);
-                }
-                debug("vd",
-                      QString("Decoder::seekTo decoded frame with PTS: %1 target: %2").arg(current_pts).arg(targetPts));
-            }
+        if (current_pts >= targetPts) {
+            av_frame_move_ref(m_pendingFrame, m_frame);
+            m_hasPendingFrame = true;
+            break;
         }
-        av_packet_unref(packet);
-        av_packet_free(&packet);
-        av_frame_free(&frame);
+        // Frames the decoder threads had started before the target was set may hold slots
+        discardFrame(m_frame);
     }
 
+    m_preRollTarget = -1;
+    codecContext->skip_frame = AVDISCARD_DEFAULT;
     currentFrameIndex = targetPts;
 }
 
@@ -1418,7 +1769,7 @@ void VideoDecoder::seek(int64_t targetPts, int loadCount) {
     debug("vd", QString("seek called with targetPts: %1").arg(targetPts));
 
     // For Y4M and YUV files, check against total frames
-    if ((m_isY4M || (codecContext && isYUV(codecContext->codec_id))) && yuvTotalFrames > 0) {
+    if ((m_isY4M || m_isRawYUV) && yuvTotalFrames > 0) {
         if (targetPts >= yuvTotalFrames) {
             warning("vd",
                     QString("seek - Target PTS %1 exceeds total frames %2, adjusting to last frame")
@@ -1444,65 +1795,106 @@ void VideoDecoder::seek(int64_t targetPts, int loadCount) {
     emit frameSeeked(targetPts);
 }
 
-int64_t VideoDecoder::loadY4MFrame() {
-    if (!m_isY4M || !m_y4mInfo.isValid) {
-        ErrorReporter::instance().report("Y4M format not properly initialized", LogLevel::Error);
-        return -1;
-    }
-
-    QFile file(QString::fromStdString(m_fileName));
-    if (!file.open(QIODevice::ReadOnly)) {
-        ErrorReporter::instance().report("Cannot open Y4M file for reading", LogLevel::Error);
+/**
+ * @brief Reads the next frames of a raw YUV or Y4M file straight into their queue slots
+ * @return Pts of the last frame read, -1 when the synchronous path has to take over
+ */
+int64_t VideoDecoder::loadFramesAsync(int num_frames) {
+    int64_t count = std::min<int64_t>(num_frames, yuvTotalFrames - currentFrameIndex);
+    if (count <= 0) {
         return -1;
     }
 
-    // Calculate current frame position in file
-    int frameDataSize = Y4MParser::calculateFrameSize(m_y4mInfo);
-    int totalFrameSize = 6 + frameDataSize; // "FRAME\n" + frame data
-    int64_t framePosition = m_y4mInfo.headerSize + currentFrameIndex * totalFrameSize;
-
-    // Check if beyond file end
-    if (framePosition >= file.size()) {
-        file.close();
-        return -1; // EOF
+    // Slots claimed for the batch are handed back empty when it cannot be read
+    auto abandonSlots = [this]() {
+        for (FrameData* frameData : m_asyncSlots) {
+            frameData->setPts(-1);
+        }
+        m_asyncSlots.clear();
+    };
+
+    int64_t frameSize = metadata.frameSize();
+    int64_t lastPts = currentFrameIndex + count - 1;
+    m_asyncReads.clear();
+    m_asyncSlots.clear();
+    for (int64_t pts = currentFrameIndex; pts <= lastPts; ++pts) {
+        FrameData* frameData = m_frameQueue->getTailFrame(pts);
+        if (frameData) {
+            m_asyncSlots.push_back(frameData);
+        }
+        if (!frameData || !frameData->yPtr()) {
+            abandonSlots();
+            return -1;
+        }
+        int64_t offset = m_isY4M ? m_y4mFrameOffsets[pts] : pts * m_rawReader.frameSize();
+        m_asyncReads.push_back({offset, frameData->yPtr(), frameSize});
     }
 
-    // Seek to frame position
-    if (!file.seek(framePosition)) {
-        ErrorReporter::instance().report("Cannot seek to frame position in Y4M file", LogLevel::Error);
-        file.close();
+    if (!m_asyncReader.read(m_asyncReads)) {
+        warning("vd", "Asynchronous frame read failed, continuing with synchronous reads");
+        m_asyncReader.close();
+        abandonSlots();
         return -1;
     }
 
-    // Read "FRAME\n" prefix
-    QByteArray frameHeader = file.read(6);
-    if (frameHeader != "FRAME\n") {
-        ErrorReporter::instance().report("Invalid Y4M frame header", LogLevel::Error);
-        file.close();
-        return -1;
+    int64_t pts = currentFrameIndex;
+    for (FrameData* frameData : m_asyncSlots) {
+        frameData->setEndFrame(pts == yuvTotalFrames - 1);
+        frameData->setPts(pts);
+        ++pts;
+    }
+    m_asyncSlots.clear();
+    if (lastPts == yuvTotalFrames - 1) {
+        m_hitEndFrame = true;
     }
 
-    // Read frame data
-    QByteArray frameData = file.read(frameDataSize);
-    if (frameData.size() != frameDataSize) {
-        ErrorReporter::instance().report("Incomplete Y4M frame data", LogLevel::Error);
-        file.close();
+    debug("vd", QString("Read frames %1 to %2 asynchronously").arg(currentFrameIndex).arg(lastPts));
+    currentFrameIndex = lastPts + 1;
+    return lastPts;
+}
+
+int64_t VideoDecoder::loadY4MFrame() {
+    if (!m_isY4M || !m_y4mInfo.isValid || !m_y4mFile.isOpen()) {
+        ErrorReporter::instance().report("Y4M format not properly initialized", LogLevel::Error);
         return -1;
     }
 
-    file.close();
+    // Frame payload offsets come from the index built in openFile()
+    if (currentFrameIndex < 0 || currentFrameIndex >= static_cast<int64_t>(m_y4mFrameOffsets.size())) {
+        return -1; // EOF
+    }
+    int64_t dataPosition = m_y4mFrameOffsets[currentFrameIndex];
 
-    // Copy frame data to FrameData structure
     int64_t pts = currentFrameIndex;
     FrameData* outputFrame = m_frameQueue->getTailFrame(pts);
-    if (!outputFrame) {
+    if (!outputFrame || !outputFrame->yPtr()) {
         ErrorReporter::instance().report("Cannot get frame from queue", LogLevel::Error);
+        if (outputFrame) {
+            outputFrame->setPts(-1);
+        }
         return -1;
     }
 
-    copyY4MFrame(frameData, outputFrame);
-
-    outputFrame->setPts(pts);
+    // Read the planes straight into the queue slot, padded rows go through a copy
+    int ySize = metadata.ySize();
+    int uvSize = metadata.uvSize();
+    bool complete;
+    if (metadata.isTightlyPacked()) {
+        complete = readY4MAt(dataPosition, outputFrame->yPtr(), ySize) &&
+                   readY4MAt(dataPosition + ySize, outputFrame->uPtr(), uvSize) &&
+                   readY4MAt(dataPosition + ySize + uvSize, outputFrame->vPtr(), uvSize);
+    } else {
+        m_y4mPayload.resize(static_cast<size_t>(ySize) + 2 * static_cast<size_t>(uvSize));
+        complete = readY4MAt(dataPosition, m_y4mPayload.data(), static_cast<int64_t>(m_y4mPayload.size()));
+        if (complete) {
+            copyToSlot(m_y4mPayload.data(), outputFrame, metadata);
+        }
+    }
+    if (!complete) {
+        ErrorReporter::instance().report("Incomplete Y4M frame data", LogLevel::Error);
+        outputFrame->setPts(-1);
+        return -1;
+    }
 
     // Check if this is the last frame
     if (currentFrameIndex == yuvTotalFrames - 1) {
@@ -1513,50 +1905,41 @@ int64_t VideoDecoder::loadY4MFrame() {
         outputFrame->setEndFrame(false);
     }
 
+    outputFrame->setPts(pts);
+
     currentFrameIndex++;
 
     debug("vd", QString("Y4M loaded frame %1").arg(pts));
     return pts;
 }
 
-void VideoDecoder::copyY4MFrame(const QByteArray& frameData, FrameData* outputFrame) {
-    if (!outputFrame || frameData.isEmpty()) {
-        return;
-    }
-
-    const uint8_t* srcData = reinterpret_cast<const uint8_t*>(frameData.constData());
-    uint8_t* yPtr = outputFrame->yPtr();
-    uint8_t* uPtr = outputFrame->uPtr();
-    uint8_t* vPtr = outputFrame->vPtr();
-
-    if (!yPtr || !uPtr || !vPtr) {
-        ErrorReporter::instance().report("Invalid frame data pointers", LogLevel::Error);
-        return;
+/**
+ * @brief Reads size bytes at the given file offset of the open Y4M file.
+ *
+ * Uses a positional read where available so the file position is never touched.
+ */
+bool VideoDecoder::readY4MAt(int64_t offset, uint8_t* dst, int64_t size) {
+#ifdef Q_OS_UNIX
+    int fd = m_y4mFile.handle();
+    while (size > 0) {
+        ssize_t bytesRead = pread(fd, dst, static_cast<size_t>(size), static_cast<off_t>(offset));
+        if (bytesRead < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytesRead <= 0) {
+            return false;
+        }
+        dst += bytesRead;
+        offset += bytesRead;
+        size -= bytesRead;
     }
-
-    int width = m_y4mInfo.width;
-    int height = m_y4mInfo.height;
-
-    // Copy data based on pixel format
-    const AVPixFmtDescriptor* pixDesc = av_pix_fmt_desc_get(m_y4mInfo.pixelFormat);
-    if (!pixDesc) {
-        ErrorReporter::instance().report("Invalid pixel format descriptor", LogLevel::Error);
-        return;
+    return true;
+#else
+    if (!m_y4mFile.seek(offset)) {
+        return false;
     }
-
-    int uvWidth = AV_CEIL_RSHIFT(width, pixDesc->log2_chroma_w);
-    int uvHeight = AV_CEIL_RSHIFT(height, pixDesc->log2_chroma_h);
-
-    // Y plane
-    int ySize = width * height;
-    memcpy(yPtr, srcData, ySize);
-
-    // U and V planes
-    int uvSize = uvWidth * uvHeight;
-    memcpy(uPtr, srcData + ySize, uvSize);
-    memcpy(vPtr, srcData + ySize + uvSize, uvSize);
-
-    debug("vd", QString("Y4M frame copied - Y size: %1, UV size: %2").arg(ySize).arg(uvSize));
+    return m_y4mFile.read(reinterpret_cast<char*>(dst), size) == size;
+#endif
 }
 
 void VideoDecoder::seekToY4M(int64_t targetPts) {
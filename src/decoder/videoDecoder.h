@@ -1,15 +1,25 @@
 #pragma once
 
+#include <QFile>
 #include <QFileInfo>
+#include <QMutex>
 #include <QObject>
+#include <atomic>
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <string>
 
+#include "asyncFrameReader.h"
 #include "frameQueue.h"
 #include "frames/frameData.h"
 #include "frames/frameMeta.h"
+#include "keyframeIndex.h"
+#include "metadataCache.h"
+#include "packetQueue.h"
+#include "rawFrameReader.h"
+#include "streamFrameReader.h"
 #include "utils/errorReporter.h"
 #include "utils/y4mParser.h"
 
@@ -17,6 +27,7 @@ extern "C" {
 #include <libavcodec/avcodec.h>
 #include <libavformat/avformat.h>
 #include <libavutil/avutil.h>
+#include <libavutil/hwcontext.h>
 #include <libavutil/imgutils.h>
 #include <libswscale/swscale.h>
 }
@@ -33,6 +44,15 @@ class VideoDecoder : public QObject {
     void setFileName(const std::string& fileName);
     void setFrameQueue(std::shared_ptr<FrameQueue> frameQueue);
     void setForceSoftwareDecoding(bool force);
+    void setDecodeThreads(int threads);
+    void setGpuUnpack(bool enabled);
+    // Compressed frames are written downscaled by 2^shift from the next frame on, safe to call from other threads
+    void setProxyShift(int shift);
+    void setStreamHistory(int frames);
+
+    // Segment decoders of one video open the file with the probe, packet index and pts offset of the
+    // primary decoder instead of scanning it again. Set before openFile(), primary has to be open already.
+    void shareProbe(const VideoDecoder* primary) { m_probeSource = primary; }
 
     void openFile();
     virtual FrameMeta getMetaData();
@@ -40,13 +60,30 @@ class VideoDecoder : public QObject {
     int64_t getDurationMs();
     int getTotalFrames();
 
+    // Raw, Y4M and intra-only codecs start decoding at any frame without a GOP walk
+    bool isIntraOnly() const;
+
+    // Next frame the decoder will load, safe to read from other threads
+    int64_t position() const { return m_position.load(std::memory_order_acquire); }
+
+    // Decoders sharing a queue leave its tail to the one serving the playback position, safe to call from other threads
+    void setPublishTail(bool publish) { m_publishTail.store(publish, std::memory_order_relaxed); }
+
+    // Reading from stdin or a named pipe, the frame count stays unknown while the stream runs
+    bool isLive() const { return m_isStream; }
+
+    // Unblocks a decoder waiting on a live stream so its thread can be stopped, safe to call from other threads
+    void interrupt();
+
   public slots:
     virtual void loadFrames(int num_frames, int direction);
     virtual void seek(int64_t timestamp, int loadCount = -1);
+    void loadRange(int64_t first, int count);
 
   signals:
     void framesLoaded(bool success);
     void frameSeeked(int64_t pts);
+    void rangeLoaded(int64_t lastPts);
 
   private:
     AVFormatContext* formatContext;
@@ -57,8 +94,12 @@ class VideoDecoder : public QObject {
     FrameMeta metadata;
     int currentFrameIndex = 0;
     int localTail = -1;
+    std::atomic<int64_t> m_position = 0;
+    std::atomic<bool> m_publishTail = true;
+    void publishTail(int64_t pts);
 
-    int64_t m_ptsOffset = -1;
+    // Read from decoder worker threads through getDirectBuffer()
+    std::atomic<int64_t> m_ptsOffset = -1;
 
     int m_width;
     int m_height;
@@ -69,14 +110,66 @@ class VideoDecoder : public QObject {
 
     int yuvTotalFrames = -1;
     bool m_forceSoftwareDecoding = false;
+    int m_decodeThreads = 0;
+    // Raw YUYV/UYVY frames are stored packed and unpacked by the renderer
+    bool m_gpuUnpack = false;
+    std::atomic<int> m_proxyShift = 0;
+
+    // Built in the background for compressed files, used to seek straight to keyframes. Shared with the
+    // segment decoders of the same video.
+    std::shared_ptr<KeyframeIndex> m_keyframeIndex = std::make_shared<KeyframeIndex>();
+    const VideoDecoder* m_probeSource = nullptr;
+
+    // Demuxes ahead on its own thread, decodeNextFrame() only ever waits on it when it runs dry
+    PacketQueue m_packetQueue;
+    int m_indexedTotalFrames = -1;
+
+    // Raw YUV files are read through a memory mapping
+    RawFrameReader m_rawReader;
+    // Reads raw and Y4M frames straight into queue slots with several requests in flight, when available
+    AsyncFrameReader m_asyncReader;
+    std::vector<AsyncFrameReader::Read> m_asyncReads;
+    // Slot claimed for each read of m_asyncReads, published once all reads completed
+    std::vector<FrameData*> m_asyncSlots;
+    AVPixelFormat m_rawFormat = AV_PIX_FMT_NONE;
+    bool m_isRawYUV = false;
+
+    // Raw or Y4M frames arriving on a pipe, served through the raw YUV path
+    StreamFrameReader m_streamReader;
+    bool m_isStream = false;
+    int m_streamHistory = 100;
 
     // Y4M format related
     Y4MInfo m_y4mInfo;
     bool m_isY4M = false;
+    QFile m_y4mFile;
+    std::vector<int64_t> m_y4mFrameOffsets;
+    // Frame payload staged here when the slot rows are padded
+    std::vector<uint8_t> m_y4mPayload;
 
     AVBufferRef* hw_device_ctx = nullptr;
     AVPixelFormat hw_pix_fmt = AV_PIX_FMT_NONE;
 
+    // Conversion context kept across frames, rebuilt only when the source format or size changes
+    SwsContext* m_swsContext = nullptr;
+
+    // Intra-only software decoding writes straight into FrameQueue slots, read from the codec worker threads
+    std::atomic<bool> m_directDecoding = false;
+    std::atomic<int64_t> m_directMinPts = 0;
+    // Frames the decoder threads work on at once, each holds its slot until it is published
+    int m_directFramesInFlight = 1;
+    // Slots claimed by getDirectBuffer() and the pts they were claimed for, until the frame is published
+    QMutex m_directMutex;
+    std::vector<std::pair<FrameData*, int64_t>> m_directSlots;
+    FrameData* takeDirectSlot(const AVFrame* frame, int64_t* pts);
+    void discardFrame(AVFrame* frame);
+    void abandonDirectSlots();
+    bool hasCachedStream(const MetadataCache::Entry& cached) const;
+    bool copyProbe(const VideoDecoder& primary, MetadataCache::Entry& entry);
+    bool canDecodeDirectly(const AVCodec* codec);
+    static int getDirectBuffer(AVCodecContext* ctx, AVFrame* frame, int flags);
+    int64_t rescalePts(int64_t rawPts) const;
+
     void closeFile();
 
     bool isYUV(AVCodecID codecId);
@@ -84,13 +177,47 @@ class VideoDecoder : public QObject {
     bool isSemiPlanarYUV(AVPixelFormat pixFmt);
     int calculateFrameSize(AVPixelFormat pixFmt, int width, int height);
     bool initializeHardwareDecoder(AVHWDeviceType deviceType, AVPixelFormat pixFmt);
-    int64_t loadYUVFrame();
+    void openStream(const QString& fileName);
+    int64_t loadYUVFrame(bool wait);
     int64_t loadY4MFrame();
-    void copyFrame(AVPacket*& tempPacket, FrameData* frameData, int& retFlag);
-    void copyY4MFrame(const QByteArray& frameData, FrameData* outputFrame);
+    int64_t loadFramesAsync(int num_frames);
+    int64_t loadSequential(int num_frames);
+    bool copyFrame(const uint8_t* packetData, FrameData* frameData);
+    bool readY4MAt(int64_t offset, uint8_t* dst, int64_t size);
     int64_t loadCompressedFrame();
+    bool writeFrame(AVFrame* frame, FrameData* frameData);
+    int decodeNextFrame(AVPacket* packet, AVFrame* frame);
+    int64_t frameTimestamp(const AVFrame* frame) const;
+
+    // Owned for the lifetime of the open file so decoding and seeking never allocate them per frame
+    AVPacket* m_packet = nullptr;
+    AVFrame* m_frame = nullptr;
+    AVFrame* m_transferFrame = nullptr;
+
+    // Seek target while walking up to it, non-reference frames before it are not decoded
+    int64_t m_preRollTarget = -1;
+
+    // First frame at or past a seek target, handed out by the next decodeNextFrame()
+    AVFrame* m_pendingFrame = nullptr;
+    bool m_hasPendingFrame = false;
+
+    // Decoded GOP frames waiting to be played backward, keyed by normalized PTS
+    std::map<int64_t, AVFrame*> m_reverseCache;
+    // Bytes of m_reverseCache, charged to the FrameArena budget
+    int64_t m_reverseCacheBytes = 0;
+    // Set once reverse playback moved the demuxer away from currentFrameIndex
+    bool m_reverseResync = false;
+    bool usesReverseCache() const;
+    int64_t loadReverseFrames(int64_t first, int64_t last);
+    void fillReverseCache(int64_t first, int64_t last);
+    size_t reverseCacheCapacity(int64_t first, int64_t last) const;
+    void cacheReverseFrame(int64_t pts, AVFrame* frame);
+    void dropReverseFrame(std::map<int64_t, AVFrame*>::iterator it);
+    void clearReverseCache();
 
     bool m_hitEndFrame = false;
+    // A frame of the last loadSequential() batch could not be converted
+    bool m_batchFailed = false;
     bool m_needsTimebaseConversion = false;
     bool m_wait = true;
 
@@ -98,4 +225,7 @@ class VideoDecoder : public QObject {
     void seekToYUV(int64_t targetPts);
     void seekToY4M(int64_t targetPts);
     void seekToCompressed(int64_t targetPts);
+    bool seekDemuxer(int64_t targetPts);
+    int64_t toStreamTimestamp(int64_t framePts) const;
+    bool canWalkForward(int64_t targetPts) const;
 };
@@ -0,0 +1,202 @@
+#include "frameArena.h"
+#include <QMutexLocker>
+#include <algorithm>
+#include <unordered_map>
+#include "frameQueue.h"
+#include "utils/appConfig.h"
+#include "utils/debugManager.h"
+
+namespace {
+// Slots start on page boundaries so frames can be read into them with O_DIRECT
+constexpr size_t kSlotAlignment = 4096;
+
+// Small frames share slabs of about this size, large ones get a slab each so reclaimed slots can
+// actually be returned to the system
+constexpr size_t kSlabBytes = 16 << 20;
+} // namespace
+
+int64_t FrameArena::budget() const {
+    return AppConfig::instance().getCacheBudget();
+}
+
+int64_t FrameArena::fairShare() const {
+    QMutexLocker locker(&m_mutex);
+    return budget() / static_cast<int64_t>(m_queues.size() + 1);
+}
+
+void FrameArena::registerQueue(FrameQueue* queue) {
+    QMutexLocker locker(&m_mutex);
+    m_queues.push_back(queue);
+}
+
+void FrameArena::unregisterQueue(FrameQueue* queue) {
+    QMutexLocker locker(&m_mutex);
+    m_queues.erase(std::remove(m_queues.begin(), m_queues.end(), queue), m_queues.end());
+}
+
+std::vector<FrameArena::Slot> FrameArena::acquire(FrameQueue* owner, size_t slotBytes, int count) {
+    QMutexLocker locker(&m_mutex);
+    std::vector<Slot> slots;
+    slots.reserve(count);
+
+    SizeClass& sizeClass = m_classes[slotBytes];
+    auto takeFree = [&]() {
+        while (static_cast<int>(slots.size()) < count && !sizeClass.free.empty()) {
+            slots.push_back(std::move(sizeClass.free.back()));
+            sizeClass.free.pop_back();
+        }
+    };
+    takeFree();
+
+    auto excess = [&]() {
+        return m_reservedBytes + m_chargedBytes + static_cast<int64_t>((count - slots.size()) * slotBytes) - budget();
+    };
+    if (budget() > 0 && excess() > 0) {
+        trim();
+    }
+
+    // Still over budget, take slots the other queues can spare, the longest idle ones first
+    if (budget() > 0 && excess() > 0) {
+        std::vector<FrameQueue*> others;
+        for (FrameQueue* queue : m_queues) {
+            if (queue != owner) {
+                others.push_back(queue);
+            }
+        }
+        std::sort(others.begin(), others.end(), [](const FrameQueue* a, const FrameQueue* b) {
+            return a->lastPlayed() < b->lastPlayed();
+        });
+
+        for (FrameQueue* queue : others) {
+            if (excess() <= 0) {
+                break;
+            }
+            size_t queueSlotBytes = queue->slotBytes();
+            int wanted = static_cast<int>((excess() + queueSlotBytes - 1) / queueSlotBytes);
+            std::vector<Slot> reclaimed = queue->reclaim(wanted);
+            if (reclaimed.empty()) {
+                continue;
+            }
+            debug("fa", QString("Reclaimed %1 slots of %2 KB").arg(reclaimed.size()).arg(queueSlotBytes >> 10));
+            m_reclaimedSlots += reclaimed.size();
+
+            SizeClass& reclaimedClass = m_classes[queueSlotBytes];
+            reclaimedClass.used -= static_cast<int64_t>(reclaimed.size());
+            for (Slot& slot : reclaimed) {
+                reclaimedClass.free.push_back(std::move(slot));
+            }
+            takeFree();
+            trim();
+        }
+    }
+
+    int missing = count - static_cast<int>(slots.size());
+    if (missing > 0) {
+        std::vector<Slot> allocated = allocateSlab(slotBytes, missing);
+        std::move(allocated.begin(), allocated.end(), std::back_inserter(slots));
+    }
+    sizeClass.used += count;
+
+    debug("fa",
+          QString("Handed out %1 slots of %2 KB, %3 MB reserved")
+              .arg(count)
+              .arg(slotBytes >> 10)
+              .arg(m_reservedBytes >> 20));
+    return slots;
+}
+
+std::vector<FrameArena::Slot> FrameArena::allocateSlab(size_t slotBytes, int count) {
+    std::vector<Slot> slots;
+    slots.reserve(count);
+    int perSlab = static_cast<int>(std::max<size_t>(kSlabBytes / slotBytes, 1));
+    while (static_cast<int>(slots.size()) < count) {
+        int slabSlots = std::min(perSlab, count - static_cast<int>(slots.size()));
+        size_t slabBytes = slotBytes * slabSlots + kSlotAlignment;
+
+        // Reserved rather than resized, zero filling gigabytes of frames would only cost time
+        auto slab = std::make_shared<std::vector<uint8_t>>();
+        slab->reserve(slabBytes);
+        uintptr_t base = reinterpret_cast<uintptr_t>(slab->data());
+        size_t baseOffset = (kSlotAlignment - base % kSlotAlignment) % kSlotAlignment;
+        for (int i = 0; i < slabSlots; ++i) {
+            slots.push_back({slab, baseOffset + i * slotBytes});
+        }
+        m_reservedBytes += static_cast<int64_t>(slab->capacity());
+    }
+    return slots;
+}
+
+void FrameArena::release(size_t slotBytes, std::vector<Slot> slots) {
+    QMutexLocker locker(&m_mutex);
+    SizeClass& sizeClass = m_classes[slotBytes];
+    sizeClass.used -= static_cast<int64_t>(slots.size());
+    for (Slot& slot : slots) {
+        sizeClass.free.push_back(std::move(slot));
+    }
+    trim();
+}
+
+void FrameArena::charge(int64_t bytes) {
+    QMutexLocker locker(&m_mutex);
+    m_chargedBytes += bytes;
+    trim();
+}
+
+void FrameArena::uncharge(int64_t bytes) {
+    QMutexLocker locker(&m_mutex);
+    m_chargedBytes -= bytes;
+}
+
+/**
+ * @brief Releases slabs whose slots are all free while the pool holds more than the budget.
+ *
+ * Without a budget queues have a fixed size and nothing is kept spare.
+ */
+void FrameArena::trim() {
+    int64_t used = m_chargedBytes;
+    for (const auto& [slotBytes, sizeClass] : m_classes) {
+        used += sizeClass.used * static_cast<int64_t>(slotBytes);
+    }
+    int64_t limit = budget() > 0 ? std::max(budget(), used) : used;
+
+    for (auto& [slotBytes, sizeClass] : m_classes) {
+        if (m_reservedBytes + m_chargedBytes <= limit) {
+            break;
+        }
+
+        // A slab is unused when every reference to it comes from the free list
+        std::unordered_map<const std::vector<uint8_t>*, long> freeSlots;
+        for (const Slot& slot : sizeClass.free) {
+            ++freeSlots[slot.slab.get()];
+        }
+        std::vector<Slot> kept;
+        for (Slot& slot : sizeClass.free) {
+            const std::vector<uint8_t>* slab = slot.slab.get();
+            if (m_reservedBytes + m_chargedBytes > limit && freeSlots[slab] == slot.slab.use_count()) {
+                freeSlots[slab] = -1;
+                m_reservedBytes -= static_cast<int64_t>(slab->capacity());
+            }
+            if (freeSlots[slab] >= 0) {
+                kept.push_back(std::move(slot));
+            }
+        }
+        sizeClass.free = std::move(kept);
+    }
+}
+
+FrameArena::Stats FrameArena::stats() const {
+    QMutexLocker locker(&m_mutex);
+    Stats stats;
+    stats.budgetBytes = budget();
+    stats.reservedBytes = m_reservedBytes;
+    stats.chargedBytes = m_chargedBytes;
+    for (const auto& [slotBytes, sizeClass] : m_classes) {
+        stats.usedBytes += sizeClass.used * static_cast<int64_t>(slotBytes);
+        if (sizeClass.used > 0 || !sizeClass.free.empty()) {
+            ++stats.sizeClasses;
+        }
+    }
+    stats.queues = static_cast<int>(m_queues.size());
+    stats.reclaimedSlots = m_reclaimedSlots;
+    return stats;
+}
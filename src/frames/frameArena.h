@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QMutex>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+class FrameQueue;
+
+// Process wide pool of frame slots shared by every FrameQueue. Slots are grouped into size classes
+// by their page aligned size and carved from larger slabs. A queue going away leaves its slots for
+// the next queue of the same geometry instead of handing the memory back to the system. When a
+// queue would push the pool past the cache budget, slots holding nothing the other queues need
+// are reclaimed from them, least recently played first.
+class FrameArena {
+  public:
+    struct Slot {
+        std::shared_ptr<std::vector<uint8_t>> slab;
+        size_t offset = 0;
+    };
+
+    struct Stats {
+        int64_t budgetBytes = 0;   // 0 when queues have a fixed size
+        int64_t reservedBytes = 0; // Held by slabs, used or not
+        int64_t usedBytes = 0;     // Handed out to queues
+        int64_t chargedBytes = 0;  // Held outside the pool, see charge()
+        int sizeClasses = 0;
+        int queues = 0;
+        uint64_t reclaimedSlots = 0; // Taken back from other queues over the process lifetime
+    };
+
+    static FrameArena& instance() {
+        static FrameArena instance;
+        return instance;
+    }
+
+    // Bytes a new queue can plan with, an equal share of the budget among the queues including it
+    int64_t fairShare() const;
+
+    // Hands count slots of slotBytes each to owner, reusing free slots before allocating slabs.
+    // The budget is soft: when reclaiming does not make room the slots are allocated anyway.
+    std::vector<Slot> acquire(FrameQueue* owner, size_t slotBytes, int count);
+
+    // Returns slots to the pool, slabs nobody uses are released once the pool exceeds the budget
+    void release(size_t slotBytes, std::vector<Slot> slots);
+
+    // Counts memory kept outside the pool against the budget, such as the decoded frames of a reverse
+    // playback GOP cache. Spare slabs are trimmed to make room and later acquires reclaim slots for it.
+    void charge(int64_t bytes);
+    void uncharge(int64_t bytes);
+
+    // Queues are asked to give back slots only while registered
+    void registerQueue(FrameQueue* queue);
+    void unregisterQueue(FrameQueue* queue);
+
+    Stats stats() const;
+
+  private:
+    FrameArena() = default;
+
+    struct SizeClass {
+        std::vector<Slot> free;
+        int64_t used = 0; // Slots handed out
+    };
+
+    std::vector<Slot> allocateSlab(size_t slotBytes, int count);
+    void trim();
+    int64_t budget() const;
+
+    mutable QMutex m_mutex;
+    std::map<size_t, SizeClass> m_classes;
+    std::vector<FrameQueue*> m_queues;
+    int64_t m_reservedBytes = 0;
+    int64_t m_chargedBytes = 0;
+    uint64_t m_reclaimedSlots = 0;
+};
@@ -1,13 +1,20 @@
 #include "frameData.h"
 #include <cassert>
+#include <cstdint>
 #include <memory>
+#include "frameMeta.h"
 
-FrameData::FrameData(int ySize, int uvSize, std::shared_ptr<std::vector<uint8_t>> bufferPtr, size_t bufferOffset) :
+FrameData::FrameData(const FrameMeta& meta, std::shared_ptr<std::vector<uint8_t>> bufferPtr, size_t bufferOffset) :
     m_bufferPtr(bufferPtr),
-    m_bufferOffset(bufferOffset) {
+    m_bufferOffset(bufferOffset),
+    m_yStride(meta.yStride()),
+    m_uvStride(meta.uvStride()) {
+    assert(!m_bufferPtr ||
+           reinterpret_cast<uintptr_t>(m_bufferPtr->data() + bufferOffset) % FrameMeta::kPlaneAlignment == 0);
+    // Plane sizes are whole strides, so every plane stays aligned like the slot
     m_planeOffset[0] = 0;
-    m_planeOffset[1] = ySize;
-    m_planeOffset[2] = ySize + uvSize;
+    m_planeOffset[1] = meta.yPlaneSize();
+    m_planeOffset[2] = meta.yPlaneSize() + meta.uvPlaneSize();
 }
 
 FrameData::~FrameData() = default;
@@ -30,18 +37,88 @@ uint8_t* FrameData::vPtr() const {
     return m_bufferPtr->data() + m_bufferOffset + m_planeOffset[2];
 }
 
+int FrameData::yStride() const {
+    return m_yStride;
+}
+
+int FrameData::uvStride() const {
+    return m_uvStride;
+}
+
 int64_t FrameData::pts() const {
-    return m_pts;
+    return m_pts.load(std::memory_order_relaxed);
 }
 
 void FrameData::setPts(int64_t pts) {
-    m_pts = pts;
+    m_pts.store(pts, std::memory_order_relaxed);
+    // Only the writer touches the word between beginWrite() and here, nobody can pin a slot being written
+    uint64_t state = m_state.load(std::memory_order_relaxed);
+    assert(!(state & kPinMask));
+    uint64_t generation = state & ~(kGenerationUnit - 1);
+    m_state.store(generation | (pts >= 0 ? Ready : Empty), std::memory_order_release);
 }
 
 bool FrameData::isEndFrame() const {
-    return m_isEndFrame;
+    return m_isEndFrame.load(std::memory_order_relaxed);
 }
 
 void FrameData::setEndFrame(bool isEndFrame) {
-    m_isEndFrame = isEndFrame;
+    m_isEndFrame.store(isEndFrame, std::memory_order_relaxed);
+}
+
+int FrameData::proxyShift() const {
+    return m_proxyShift.load(std::memory_order_relaxed);
+}
+
+void FrameData::setProxyShift(int shift) {
+    m_proxyShift.store(shift, std::memory_order_relaxed);
+}
+
+bool FrameData::isReady() const {
+    return (m_state.load(std::memory_order_acquire) & kPhaseMask) == Ready;
+}
+
+bool FrameData::isWriting() const {
+    return (m_state.load(std::memory_order_acquire) & kPhaseMask) == Writing;
+}
+
+bool FrameData::isPinned() const {
+    return (m_state.load(std::memory_order_acquire) & kPinMask) != 0;
+}
+
+uint32_t FrameData::generation() const {
+    return static_cast<uint32_t>(m_state.load(std::memory_order_acquire) >> 32);
+}
+
+bool FrameData::pin(int64_t pts) {
+    uint64_t state = m_state.load(std::memory_order_acquire);
+    do {
+        // The pts read belongs to the generation in state, the exchange fails if a write started since
+        if ((state & kPhaseMask) != Ready || m_pts.load(std::memory_order_relaxed) != pts) {
+            return false;
+        }
+    } while (!m_state.compare_exchange_weak(state, state + kPinUnit, std::memory_order_acquire));
+    return true;
+}
+
+void FrameData::unpin() {
+    assert(isPinned());
+    m_state.fetch_sub(kPinUnit, std::memory_order_release);
+}
+
+bool FrameData::beginWrite() {
+    uint64_t state = m_state.load(std::memory_order_acquire);
+    do {
+        if (state & kPinMask) {
+            return false;
+        }
+    } while (!m_state.compare_exchange_weak(state,
+                                            (state & ~(kGenerationUnit - 1)) + kGenerationUnit + Writing,
+                                            std::memory_order_acquire));
+    return true;
+}
+
+void FrameData::releaseBuffer() {
+    assert((m_state.load(std::memory_order_relaxed) & kPhaseMask) == Writing);
+    m_bufferPtr.reset();
 }
@@ -1,30 +1,102 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <vector>
 
+class FrameMeta;
+
+// A frame slot of a FrameQueue. Its state word holds the phase (empty, being written or ready), the
+// number of readers pinning it and a generation bumped on every write. The decoder claims a slot
+// with beginWrite() and publishes it with setPts(), readers pin a ready frame before touching its
+// pixels. Neither side takes a lock, a slot with pins is simply not written.
 class FrameData {
   public:
-    FrameData(int ySize, int uvSize, std::shared_ptr<std::vector<uint8_t>> bufferPtr, size_t bufferOffset);
+    // Lays the planes out in the buffer with the padded strides of meta, bufferOffset must be 64 byte aligned
+    FrameData(const FrameMeta& meta, std::shared_ptr<std::vector<uint8_t>> bufferPtr, size_t bufferOffset);
     ~FrameData();
 
+    FrameData(const FrameData&) = delete;
+    FrameData& operator=(const FrameData&) = delete;
+
     uint8_t* yPtr() const;
     uint8_t* uPtr() const;
     uint8_t* vPtr() const;
+    // Bytes between the starts of two rows, a multiple of FrameMeta::kPlaneAlignment
+    int yStride() const;
+    int uvStride() const;
     int64_t pts() const;
+    // Publishes the frame written since beginWrite(), a negative pts leaves the slot empty
     void setPts(int64_t pts);
     bool isEndFrame() const;
     void setEndFrame(bool isEndFrame);
+    // Proxy frames are stored downscaled by 2^shift in the slot's pixel format at the top left of the
+    // full size planes, rows keep the full resolution strides. 0 for full resolution.
+    int proxyShift() const;
+    void setProxyShift(int shift);
+
+    // True once a frame has been published and until the slot is claimed again
+    bool isReady() const;
+    // Claimed by the decoder and not published yet
+    bool isWriting() const;
+    bool isPinned() const;
+    uint32_t generation() const;
+
+    // Keeps the decoder off the slot while it still holds the finished frame of pts. Every successful
+    // pin needs an unpin().
+    bool pin(int64_t pts);
+    void unpin();
+
+    // Claims the slot for the decoder, fails while a reader pins it
+    bool beginWrite();
+
+    // Lets go of the memory of a slot claimed for good, the queue gives it back to the arena
+    void releaseBuffer();
 
     // TODO: deal with inconsistent frame size
 
   private:
-    int64_t m_pts = -1;
+    // generation << 32 | pins << 2 | phase
+    static constexpr uint64_t kPhaseMask = 3;
+    static constexpr uint64_t kPinUnit = 4;
+    static constexpr uint64_t kPinMask = 0xffffffffu & ~kPhaseMask;
+    static constexpr uint64_t kGenerationUnit = uint64_t(1) << 32;
+    enum Phase : uint64_t {
+        Empty = 0,
+        Writing = 1,
+        Ready = 2
+    };
+
+    std::atomic<uint64_t> m_state = Empty;
+    std::atomic<int64_t> m_pts = -1;
     std::shared_ptr<std::vector<uint8_t>> m_bufferPtr;
     size_t m_bufferOffset;
     std::array<size_t, 3> m_planeOffset;
-    bool m_isEndFrame = false;
+    int m_yStride;
+    int m_uvStride;
+    // Set after publishing too, when the end of the video is found later
+    std::atomic<bool> m_isEndFrame = false;
+    std::atomic<int> m_proxyShift = 0;
+};
+
+// Pins a frame for the lifetime of a scope, false when the frame of pts is gone
+class FramePin {
+  public:
+    FramePin(FrameData* frame, int64_t pts) : m_frame(frame && frame->pin(pts) ? frame : nullptr) {}
+    ~FramePin() {
+        if (m_frame) {
+            m_frame->unpin();
+        }
+    }
+
+    FramePin(const FramePin&) = delete;
+    FramePin& operator=(const FramePin&) = delete;
+
+    explicit operator bool() const { return m_frame != nullptr; }
+
+  private:
+    FrameData* m_frame;
 };
\ No newline at end of file
@@ -30,6 +30,54 @@ int FrameMeta::uvSize() const {
     return uvWidth() * uvHeight();
 }
 
+int FrameMeta::yRowBytes() const {
+    return isPacked() ? yWidth() * 2 : yWidth();
+}
+
+int FrameMeta::uvRowBytes() const {
+    if (isPacked()) {
+        return 0;
+    }
+    return isSemiPlanar() ? uvWidth() * 2 : uvWidth();
+}
+
+int FrameMeta::yStride() const {
+    return alignedStride(yRowBytes());
+}
+
+int FrameMeta::uvStride() const {
+    return alignedStride(uvRowBytes());
+}
+
+int FrameMeta::yPlaneSize() const {
+    return yStride() * yHeight();
+}
+
+int FrameMeta::uvPlaneSize() const {
+    return uvStride() * uvHeight();
+}
+
+int FrameMeta::frameSize() const {
+    // Semi-planar chroma is a single interleaved plane
+    return yPlaneSize() + (isSemiPlanar() ? 1 : 2) * uvPlaneSize();
+}
+
+bool FrameMeta::isTightlyPacked() const {
+    return yStride() == yRowBytes() && uvStride() == uvRowBytes();
+}
+
+int FrameMeta::alignedStride(int rowBytes) {
+    return (rowBytes + kPlaneAlignment - 1) / kPlaneAlignment * kPlaneAlignment;
+}
+
+bool FrameMeta::isSemiPlanar() const {
+    return m_fmt == AV_PIX_FMT_NV12 || m_fmt == AV_PIX_FMT_NV21;
+}
+
+bool FrameMeta::isPacked() const {
+    return m_fmt == AV_PIX_FMT_YUYV422 || m_fmt == AV_PIX_FMT_UYVY422;
+}
+
 AVPixelFormat FrameMeta::format() const {
     return m_fmt;
 }
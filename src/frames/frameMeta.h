@@ -11,6 +11,9 @@ extern "C" {
 
 class FrameMeta {
   public:
+    // Every row and plane of a slot starts on this boundary, wide enough for any SIMD load
+    static constexpr int kPlaneAlignment = 64;
+
     FrameMeta();
     ~FrameMeta();
 
@@ -20,6 +23,22 @@ class FrameMeta {
     int uvHeight() const;
     int ySize() const;
     int uvSize() const;
+    // Bytes of picture data in one row, and the padded distance between rows in a slot
+    int yRowBytes() const;
+    int uvRowBytes() const;
+    int yStride() const;
+    int uvStride() const;
+    // Bytes a plane takes up in a slot including row padding, packed frames have no chroma plane
+    int yPlaneSize() const;
+    int uvPlaneSize() const;
+    int frameSize() const;
+    // True when no row is padded, a slot then holds the frame exactly as raw files store it
+    bool isTightlyPacked() const;
+    static int alignedStride(int rowBytes);
+    // NV12/NV21 keep chroma as one interleaved plane of uvWidth x uvHeight pairs at uPtr()
+    bool isSemiPlanar() const;
+    // YUYV/UYVY keep the whole frame as packed 4:2:2 at yPtr(), two bytes per pixel
+    bool isPacked() const;
     int totalFrames() const;
     int64_t duration() const;
 
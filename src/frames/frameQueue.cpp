@@ -1,36 +1,95 @@
 #include "frameQueue.h"
+#include <QMutexLocker>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <thread>
 #include "utils/debugManager.h"
 
+namespace {
+// Slots start on page boundaries so frames can be read into them with O_DIRECT
+constexpr size_t kSlotAlignment = 4096;
+
+// Decode batches are half the queue and seeks preload a quarter behind the target. Below the
+// minimum playback starves, above the maximum every seek decodes more than it shows.
+constexpr int kMinBudgetSlots = 8;
+constexpr int kMaxBudgetSlots = 256;
+
+// Seek origins kept resident at once, and their extent around the origin as a fraction of the queue
+constexpr size_t kKeptRanges = 2;
+constexpr int kKeptRadiusDivisor = 8;
+
+size_t slotStride(const FrameMeta& meta) {
+    size_t frameSize = static_cast<size_t>(meta.frameSize());
+    return (frameSize + kSlotAlignment - 1) / kSlotAlignment * kSlotAlignment;
+}
+} // namespace
+
 FrameQueue::FrameQueue(std::shared_ptr<FrameMeta> meta, int queueSize) :
     m_metaPtr(meta),
     m_queueSize(queueSize) {
-    int ySize = m_metaPtr->ySize();
-    int uvSize = m_metaPtr->uvSize();
-    size_t frameSize = ySize + uvSize * 2;
-    size_t bufferSize = frameSize * m_queueSize;
+    m_slotBytes = slotStride(*m_metaPtr);
 
-    m_bufferPtr = std::make_shared<std::vector<uint8_t>>();
-    m_bufferPtr->reserve(bufferSize);
+    // Slots come from the process wide arena, a queue of the same geometry may have left them behind
+    std::vector<FrameArena::Slot> memory = FrameArena::instance().acquire(this, m_slotBytes, queueSize);
 
     // Allocate frame data queue
-    m_queue.reserve(m_queueSize);
-    for (int i = 0; i < m_queueSize; ++i) {
-        m_queue.emplace_back(ySize, uvSize, m_bufferPtr, i * frameSize);
+    m_slots.resize(queueSize);
+    m_slotOf.reserve(queueSize);
+    m_lastUse = std::make_unique<std::atomic<uint64_t>[]>(queueSize);
+    for (int i = 0; i < queueSize; ++i) {
+        m_queue.emplace_back(*m_metaPtr, memory[i].slab, memory[i].offset);
+        m_slots[i].memory = std::move(memory[i]);
+    }
+    FrameArena::instance().registerQueue(this);
+}
+
+int FrameQueue::slotsForBudget(const FrameMeta& meta, int64_t budgetBytes) {
+    int64_t stride = static_cast<int64_t>(std::max<size_t>(slotStride(meta), 1));
+    int64_t slots = std::min<int64_t>(budgetBytes / stride, kMaxBudgetSlots);
+    // Short clips fit completely, a larger ring would only hold empty slots
+    if (meta.totalFrames() > 0) {
+        slots = std::min<int64_t>(slots, meta.totalFrames());
     }
+    return static_cast<int>(std::max<int64_t>(slots, kMinBudgetSlots));
 }
 
-FrameQueue::~FrameQueue() = default;
+FrameQueue::~FrameQueue() {
+    FrameArena::instance().unregisterQueue(this);
+
+    std::vector<FrameArena::Slot> memory;
+    for (SlotState& state : m_slots) {
+        if (!state.retired) {
+            memory.push_back(std::move(state.memory));
+        }
+    }
+    // The frames still reference their slabs, they have to go before the arena can count them as free
+    m_queue.clear();
+    FrameArena::instance().release(m_slotBytes, std::move(memory));
+}
 
 int FrameQueue::getEmpty(int direction) {
     int64_t tailVal = tail.load(std::memory_order_acquire);
     int64_t headVal = head.load(std::memory_order_acquire);
 
+    {
+        QMutexLocker locker(&m_mutex);
+        m_direction = direction;
+    }
+
+    // The head sits in a cached range the decoder is not extending, it seeks on once the range runs out
+    if (direction == 1 && isStale(headVal)) {
+        debug("fq", QString("head: %1 not reached from tail: %2").arg(headVal).arg(tailVal));
+        return 0;
+    }
+
     int empty = 0;
 
     if (direction == 1) {
-        empty = (headVal + m_queueSize / 2) - tailVal;
+        empty = (headVal + getSize() / 2) - tailVal;
     } else {
-        empty = (tailVal + m_queueSize / 2) - headVal;
+        empty = (tailVal + getSize() / 2) - headVal;
     }
 
     debug("fq", QString("tail: %1 head: %2 empty: %3").arg(tailVal).arg(headVal).arg(empty));
@@ -42,22 +101,219 @@ int FrameQueue::getEmpty(int direction) {
     return empty;
 }
 
-// IMPORTANT: Must not call decoder when seeking / stepping
+int FrameQueue::findReady(int64_t pts) const {
+    // A few hundred slots at most, scanning them beats any index readers would have to lock
+    for (int i = 0; i < static_cast<int>(m_queue.size()); ++i) {
+        if (m_queue[i].pts() == pts && m_queue[i].isReady()) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 FrameData* FrameQueue::getHeadFrame(int64_t pts) {
-    debug("fq", QString("Tail: %1").arg(tail.load(std::memory_order_acquire)));
-    FrameData* target = &m_queue[pts % m_queueSize];
+    int slot = findReady(pts);
+    if (slot < 0) {
+        return nullptr;
+    }
+    m_lastUse[slot].store(m_clock.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    head.store(pts, std::memory_order_release);
+    m_lastPlayed.store(std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::steady_clock::now().time_since_epoch())
+                           .count(),
+                       std::memory_order_relaxed);
+    return &m_queue[slot];
+}
 
-    if (target->pts() == pts) {
-        head.store(pts, std::memory_order_release);
-        return target;
+FrameData* FrameQueue::getTailFrame(int64_t pts) {
+    QMutexLocker locker(&m_mutex);
+    for (;;) {
+        if (FrameData* frame = claimTail(pts)) {
+            return frame;
+        }
+
+        // Every candidate is pinned or a reader pinned the victim just now, readers only hold pins briefly
+        locker.unlock();
+        std::this_thread::yield();
+        locker.relock();
     }
+}
 
-    return nullptr;
+FrameData* FrameQueue::tryGetTailFrame(int64_t pts) {
+    QMutexLocker locker(&m_mutex);
+    return claimTail(pts);
 }
 
-FrameData* FrameQueue::getTailFrame(int64_t pts) {
-    debug("fq", QString("Tail index: %1").arg(pts % m_queueSize));
-    return &m_queue[pts % m_queueSize];
+FrameData* FrameQueue::claimTail(int64_t pts) {
+    // A slot still waiting for its frame is written again, a finished frame stays readable until the
+    // copy decoded now is published. A slot being written for pts by someone else is left to them.
+    auto it = m_slotOf.find(pts);
+    bool pending = it != m_slotOf.end() && !m_queue[it->second].isReady() && !m_queue[it->second].isWriting();
+    int slot = pending ? it->second : pickVictim(head.load(std::memory_order_acquire));
+    if (slot < 0 || !m_queue[slot].beginWrite()) {
+        return nullptr;
+    }
+
+    SlotState& state = m_slots[slot];
+    if (state.pts != pts) {
+        // Called for every decoded frame, skip building the message unless it is printed
+        if (state.pts >= 0 && DebugManager::instance().isEnabled(QStringLiteral("fq"))) {
+            debug("fq", QString("Frame %1 evicted for %2").arg(state.pts).arg(pts));
+        }
+        auto previous = m_slotOf.find(state.pts);
+        if (previous != m_slotOf.end() && previous->second == slot) {
+            m_slotOf.erase(previous);
+        }
+        m_slotOf[pts] = slot;
+        state.pts = pts;
+    }
+    m_lastUse[slot].store(m_clock.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    state.written = ++m_writes;
+    return &m_queue[slot];
+}
+
+void FrameQueue::markEndFrame(int64_t pts) {
+    for (FrameData& frame : m_queue) {
+        if (frame.pts() == pts && frame.isReady()) {
+            frame.setEndFrame(true);
+        }
+    }
+}
+
+/**
+ * @brief How readily the frame in a slot can go, higher ranks first.
+ *
+ * Empty slots rank highest, then least recently used frames outside every protected range, then
+ * frames of the kept seek origins and then of the playhead window, furthest from their centre
+ * first. The head itself, pinned frames, slots still being written and the last half queue of writes,
+ * the batch in progress, rank -1 and never go, so a batch cannot overwrite its own frames. A copy superseded by a newer
+ * one counts as empty, unless it is the head and the newer copy is not finished yet.
+ * @param age Set to the order within the rank, larger goes first
+ */
+int FrameQueue::evictionRank(int slot, int64_t headVal, uint64_t* age) const {
+    const SlotState& state = m_slots[slot];
+    int size = getSize();
+    // Frames decoded into their slots by several decoder threads at once hold them until published
+    if (state.retired || m_queue[slot].isPinned() || m_queue[slot].isWriting()) {
+        return -1;
+    }
+    *age = 0;
+    // Never written, or handed back empty by a write that failed
+    if (state.written == 0 || !m_queue[slot].isReady()) {
+        return 4;
+    }
+    auto current = m_slotOf.find(state.pts);
+    if (current != m_slotOf.end() && current->second != slot) {
+        return state.pts == headVal && !m_queue[current->second].isReady() ? -1 : 4;
+    }
+    if (state.pts == headVal || m_writes - state.written < static_cast<uint64_t>(std::max(size / 2, 1))) {
+        return -1;
+    }
+
+    int64_t ahead = size / 2;
+    int64_t behind = size / 4;
+    int64_t windowFirst = m_direction == 1 ? headVal - behind : headVal - ahead;
+    int64_t windowLast = m_direction == 1 ? headVal + ahead : headVal + behind;
+    if (state.pts >= windowFirst && state.pts <= windowLast) {
+        *age = static_cast<uint64_t>(std::abs(state.pts - headVal));
+        return 1;
+    }
+    for (const auto& range : m_kept) {
+        if (state.pts >= range.first && state.pts <= range.second) {
+            *age = static_cast<uint64_t>(std::abs(state.pts - (range.first + range.second) / 2));
+            return 2;
+        }
+    }
+    *age = m_clock.load(std::memory_order_relaxed) - m_lastUse[slot].load(std::memory_order_relaxed);
+    return 3;
+}
+
+int FrameQueue::pickVictim(int64_t headVal) const {
+    // Only a queue smaller than a batch runs out of candidates, the oldest unpinned finished write then
+    // goes. -1 when every slot is pinned or being written.
+    int victim = -1;
+    int victimRank = -1;
+    uint64_t oldestWrite = UINT64_MAX;
+    for (int i = 0; i < static_cast<int>(m_slots.size()); ++i) {
+        if (!m_slots[i].retired && !m_queue[i].isPinned() && !m_queue[i].isWriting() &&
+            m_slots[i].written < oldestWrite) {
+            victim = i;
+            oldestWrite = m_slots[i].written;
+        }
+    }
+
+    uint64_t victimAge = 0;
+    for (int i = 0; i < static_cast<int>(m_slots.size()); ++i) {
+        uint64_t age = 0;
+        int rank = evictionRank(i, headVal, &age);
+        if (rank > victimRank || (rank == victimRank && age > victimAge)) {
+            victim = i;
+            victimRank = rank;
+            victimAge = age;
+        }
+    }
+    return victim;
+}
+
+/**
+ * @brief Retires up to wanted slots that hold nothing a protected range needs.
+ *
+ * The queue keeps at least the minimum a playback window needs. Retired slots stay in the queue
+ * without memory and are never picked again.
+ */
+std::vector<FrameArena::Slot> FrameQueue::reclaim(int wanted) {
+    QMutexLocker locker(&m_mutex);
+    int64_t headVal = head.load(std::memory_order_acquire);
+
+    std::vector<std::pair<uint64_t, int>> candidates;
+    for (int i = 0; i < static_cast<int>(m_slots.size()); ++i) {
+        uint64_t age = 0;
+        int rank = evictionRank(i, headVal, &age);
+        if (rank >= 3) {
+            // Empty slots before any frame
+            candidates.emplace_back(rank == 4 ? UINT64_MAX : age, i);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), std::greater<>());
+
+    int limit = std::min(wanted, getSize() - kMinBudgetSlots);
+    std::vector<FrameArena::Slot> memory;
+    for (const auto& candidate : candidates) {
+        if (static_cast<int>(memory.size()) >= limit) {
+            break;
+        }
+        // Claimed for good, a reader may have pinned it since it was ranked
+        int slot = candidate.second;
+        if (!m_queue[slot].beginWrite()) {
+            continue;
+        }
+        SlotState& state = m_slots[slot];
+        auto current = m_slotOf.find(state.pts);
+        if (current != m_slotOf.end() && current->second == slot) {
+            m_slotOf.erase(current);
+        }
+        state.pts = -1;
+        state.retired = true;
+        memory.push_back(std::move(state.memory));
+        // Drops the frame's reference so the arena can free the slab
+        m_queue[slot].releaseBuffer();
+    }
+    int count = static_cast<int>(memory.size());
+    if (count > 0) {
+        m_queueSize.fetch_sub(count, std::memory_order_relaxed);
+        debug("fq", QString("Gave %1 slots back, %2 left").arg(count).arg(getSize()));
+    }
+    return memory;
+}
+
+bool FrameQueue::isCached(int64_t pts) const {
+    auto it = m_slotOf.find(pts);
+    if (it == m_slotOf.end()) {
+        return false;
+    }
+    // While pts is decoded again the previous copy is still there
+    const FrameData& frame = m_queue[it->second];
+    return (frame.isReady() && frame.pts() == pts) || findReady(pts) >= 0;
 }
 
 // IMPORTANT: Needs to be called after done decoding
@@ -70,7 +326,26 @@ void FrameQueue::updateTail(int64_t pts) {
 
 bool FrameQueue::isStale(int64_t pts) {
     int64_t tailVal = tail.load(std::memory_order_acquire);
-    int size = m_queueSize;
-    // Window is [tailVal - size + 1, tailVal]
-    return !((pts >= tailVal - size + 1) && (pts <= tailVal));
-}
\ No newline at end of file
+    if (pts > tailVal || tailVal - pts >= getSize()) {
+        return true;
+    }
+    return cachedRunEnd(pts) < tailVal;
+}
+
+int64_t FrameQueue::cachedRunEnd(int64_t pts) {
+    QMutexLocker locker(&m_mutex);
+    int64_t last = pts - 1;
+    while (last - pts + 1 < getSize() && isCached(last + 1)) {
+        ++last;
+    }
+    return last;
+}
+
+void FrameQueue::keepAround(int64_t pts) {
+    int64_t radius = getSize() / kKeptRadiusDivisor;
+    QMutexLocker locker(&m_mutex);
+    m_kept.emplace_front(pts - radius, pts + radius);
+    if (m_kept.size() > kKeptRanges) {
+        m_kept.pop_back();
+    }
+}
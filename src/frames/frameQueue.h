@@ -4,9 +4,22 @@
 #include <QWaitCondition>
 #include <atomic>
 #include <cstdint>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "frameArena.h"
 #include "frameData.h"
 #include "frameMeta.h"
 
+// Frames are cached by pts rather than in a ring, so several disjoint ranges can stay resident:
+// the window around the playhead, the most recent writes and the ranges kept around earlier seek
+// origins. Everything else is evicted least recently used first.
+//
+// Readers never lock: they find frames through the slot states and pin what they read (see
+// FrameData). The decoder side keeps its bookkeeping under a mutex and never claims a pinned slot.
+// A frame decoded again goes to a fresh slot, the finished copy stays readable meanwhile.
 class FrameQueue {
   public:
     // Takes in FrameMeta to initialize the queue
@@ -16,25 +29,54 @@ class FrameQueue {
     // Getter for metaData
     std::shared_ptr<FrameMeta> metaPtr() const { return m_metaPtr; };
 
-    // Getter the current frame data pointer for renderer
-    // Should be thread-safe - block until there is frame to read
+    // Finished frame of pts, nullptr while it is not cached. Lock free. The frame may be replaced at
+    // any time unless it is pinned, pin it with pts before reading its pixels.
     FrameData* getHeadFrame(int64_t pts);
 
-    // Get the next frame to be loaded for decoder
-    // Should be thread-safe - block until there is space to write
+    // Claims the slot the decoder writes pts into, evicting the least valuable unpinned frame. The
+    // frame becomes visible to readers once the decoder publishes it with FrameData::setPts().
     FrameData* getTailFrame(int64_t pts);
 
+    // Like getTailFrame() but nullptr instead of waiting when every slot is pinned or being written
+    FrameData* tryGetTailFrame(int64_t pts);
+
+    // Flags the finished frame of pts as the last one of the video, found out after publishing it
+    void markEndFrame(int64_t pts);
+
     void updateTail(int64_t pts);
 
-    const int getSize() const { return m_queueSize; }
+    // Slots currently held, shrinks when the arena reclaims slots for another video
+    int getSize() const { return m_queueSize.load(std::memory_order_relaxed); }
+
+    // Slots that fit frames of this size into budgetBytes, clamped to what playback and seeking can use
+    static int slotsForBudget(const FrameMeta& meta, int64_t budgetBytes);
 
     int getEmpty(int direction);
 
+    // True unless every frame from pts up to the tail is cached, i.e. decoding on from the tail
+    // would not continue the frames around pts
     bool isStale(int64_t pts);
 
+    // Last pts of the unbroken run of cached frames starting at pts, pts - 1 when pts is not cached
+    int64_t cachedRunEnd(int64_t pts);
+
+    // Keeps the frames around pts resident after the playhead moves away, for jumping back
+    void keepAround(int64_t pts);
+
+    // Size of every slot, the arena size class the queue draws from
+    size_t slotBytes() const { return m_slotBytes; }
+
+    // Milliseconds on a steady clock when a frame was last read for display
+    int64_t lastPlayed() const { return m_lastPlayed.load(std::memory_order_relaxed); }
+
+    // Gives up to wanted slots back to the arena, only ones holding frames no protected range needs
+    std::vector<FrameArena::Slot> reclaim(int wanted);
+
   private:
     // Size of the queue
-    const int m_queueSize;
+    std::atomic<int> m_queueSize;
+    size_t m_slotBytes = 0;
+    std::atomic<int64_t> m_lastPlayed = 0;
 
     // Points to current frame
     // access by using
@@ -49,9 +91,31 @@ class FrameQueue {
     // Frame metadata
     std::shared_ptr<FrameMeta> m_metaPtr;
 
-    // Shared buffer for the raw YUV data
-    std::shared_ptr<std::vector<uint8_t>> m_bufferPtr;
+    // Frame slots, a deque so frames with atomic state never move
+    std::deque<FrameData> m_queue;
+
+    // Read and written by readers too, hence apart from the decoder side bookkeeping
+    std::unique_ptr<std::atomic<uint64_t>[]> m_lastUse; // m_clock at the last read or write
+    std::atomic<uint64_t> m_clock = 0;
+
+    struct SlotState {
+        int64_t pts = -1;     // Last pts the slot was claimed for
+        uint64_t written = 0; // m_writes after the write that filled the slot, 0 for never
+        bool retired = false; // Memory went back to the arena
+        FrameArena::Slot memory;
+    };
+    int findReady(int64_t pts) const;
+    FrameData* claimTail(int64_t pts);
+    int pickVictim(int64_t headVal) const;
+    int evictionRank(int slot, int64_t headVal, uint64_t* age) const;
+    bool isCached(int64_t pts) const;
 
-    // Frame data queue
-    std::vector<FrameData> m_queue;
+    // Guards the decoder side bookkeeping, readers never take it
+    mutable QMutex m_mutex;
+    std::vector<SlotState> m_slots;
+    // Slot most recently claimed for each pts
+    std::unordered_map<int64_t, int> m_slotOf;
+    uint64_t m_writes = 0;
+    int m_direction = 1;
+    std::deque<std::pair<int64_t, int64_t>> m_kept;
 };
\ No newline at end of file
@@ -18,6 +18,7 @@
 #include "controller/videoController.h"
 #include "decoder/videoDecoder.h"
 #include "rendering/videoRenderer.h"
+#include "ui/thumbnailProvider.h"
 #include "ui/videoLoader.h"
 #include "ui/videoWindow.h"
 #include "utils/aboutHelper.h"
@@ -27,6 +28,14 @@
 #include "utils/videoFileInfo.h"
 #include "utils/videoFormatUtils.h"
 
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#elif defined(Q_OS_MACOS)
+#include <sys/sysctl.h>
+#elif defined(Q_OS_UNIX)
+#include <unistd.h>
+#endif
+
 // These macros are here to prevent editors from complaining
 // To change version and name please go to CMakeLists.txt
 #ifndef APP_VERSION
@@ -37,6 +46,30 @@
 #define APP_NAME "Visual Inspection Tool"
 #endif
 
+namespace {
+// Share of the installed memory the frame cache takes without --cache-mb
+constexpr int64_t kAutoCacheDivisor = 4;
+
+// Installed memory in bytes, 0 when it cannot be determined
+int64_t physicalMemory() {
+#if defined(Q_OS_WIN)
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    return GlobalMemoryStatusEx(&status) ? static_cast<int64_t>(status.ullTotalPhys) : 0;
+#elif defined(Q_OS_MACOS)
+    int64_t memory = 0;
+    size_t size = sizeof(memory);
+    return sysctlbyname("hw.memsize", &memory, &size, nullptr, 0) == 0 ? memory : 0;
+#elif defined(Q_OS_UNIX)
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long pageSize = sysconf(_SC_PAGE_SIZE);
+    return pages > 0 && pageSize > 0 ? static_cast<int64_t>(pages) * pageSize : 0;
+#else
+    return 0;
+#endif
+}
+} // namespace
+
 int main(int argc, char* argv[]) {
     // Force OpenGL backend on macOS to avoid Metal issues
     // This ensures consistent behavior whether launched from CLI or app bundle
@@ -77,6 +110,8 @@ int main(int argc, char* argv[]) {
                                      "Example: myvideo.yuv:1920x1080:25:444P\n"
                                      "Example: myvideo.yuv:420P:1280x720\n"
                                      "For Y4M files, just provide the path (parameters read from header).\n"
+                                     "Use - to read Y4M from stdin, or -:resolution[:framerate][:pixelformat] for raw "
+                                     "YUV. Named pipes work like files.\n"
                                      "For compressed formats (e.g., mp4), just provide the path.");
     parser.addVersionOption();
     parser.addHelpOption();
@@ -88,13 +123,46 @@ int main(int argc, char* argv[]) {
                                    "components");
     parser.addOption(debugOption);
 
-    QCommandLineOption queueSizeOption({"q", "queue-size"}, QLatin1String("Frame queue size"), QLatin1String("size"));
+    QCommandLineOption queueSizeOption(
+        {"q", "queue-size"}, QLatin1String("Fixed frame queue size instead of a memory budget"), QLatin1String("size"));
     parser.addOption(queueSizeOption);
 
+    QCommandLineOption cacheOption(
+        "cache-mb",
+        QLatin1String("Memory for decoded frames shared by all videos (default: a quarter of the installed RAM)"),
+        QLatin1String("MB"));
+    parser.addOption(cacheOption);
+
     QCommandLineOption softwareOption({"s", "software"},
                                       QLatin1String("Force software decoding (disable hardware acceleration)"));
     parser.addOption(softwareOption);
 
+    QCommandLineOption decodeThreadsOption({"t", "decode-threads"},
+                                           QLatin1String("Number of software decoding threads (0 = auto)"),
+                                           QLatin1String("count"));
+    parser.addOption(decodeThreadsOption);
+
+    QCommandLineOption gpuUnpackOption(
+        "gpu-unpack", QLatin1String("Unpack raw packed 4:2:2 video (YUYV/UYVY) on the GPU instead of the CPU"));
+    parser.addOption(gpuUnpackOption);
+
+    QCommandLineOption decodersOption(
+        "decoders",
+        QLatin1String("Decoder instances per video, each serving a region of the timeline (default 1)"),
+        QLatin1String("count"));
+    parser.addOption(decodersOption);
+
+    QCommandLineOption proxyOption(
+        "proxy",
+        QLatin1String("Play zoomed out compressed videos from downscaled frames, full resolution on pause"));
+    parser.addOption(proxyOption);
+
+    QCommandLineOption streamHistoryOption(
+        "stream-history",
+        QLatin1String("Frames kept for stepping back through video read from stdin or a pipe (default 100)"),
+        QLatin1String("frames"));
+    parser.addOption(streamHistoryOption);
+
     parser.process(app);
     const QStringList args = parser.positionalArguments();
 
@@ -124,6 +192,70 @@ int main(int argc, char* argv[]) {
         debug("main", QString("Setting frame queue size to: %1").arg(queueSize), true);
     }
 
+    // Queues are sized from a memory budget unless a fixed size was asked for
+    if (parser.isSet(cacheOption)) {
+        bool ok;
+        int64_t cacheMb = parser.value(cacheOption).toLongLong(&ok);
+        if (!ok || cacheMb <= 0) {
+            ErrorReporter::instance().report(QString("Invalid cache size: %1").arg(parser.value(cacheOption)),
+                                             LogLevel::Error);
+            return -1;
+        }
+        AppConfig::instance().setCacheBudget(cacheMb << 20);
+    } else if (!parser.isSet(queueSizeOption)) {
+        AppConfig::instance().setCacheBudget(physicalMemory() / kAutoCacheDivisor);
+    }
+    if (AppConfig::instance().getCacheBudget() > 0) {
+        debug("main", QString("Frame cache budget: %1 MB").arg(AppConfig::instance().getCacheBudget() >> 20), true);
+    }
+
+    // Parse decode threads option
+    if (parser.isSet(decodeThreadsOption)) {
+        bool ok;
+        int decodeThreads = parser.value(decodeThreadsOption).toInt(&ok);
+        if (!ok || decodeThreads < 0) {
+            ErrorReporter::instance().report(
+                QString("Invalid decode thread count: %1").arg(parser.value(decodeThreadsOption)), LogLevel::Error);
+            return -1;
+        }
+        AppConfig::instance().setDecodeThreads(decodeThreads);
+        debug("main", QString("Setting decode threads to: %1").arg(decodeThreads), true);
+    }
+
+    if (parser.isSet(gpuUnpackOption)) {
+        AppConfig::instance().setGpuUnpack(true);
+        debug("main", "Unpacking packed 4:2:2 video on the GPU", true);
+    }
+
+    if (parser.isSet(decodersOption)) {
+        bool ok;
+        int decoders = parser.value(decodersOption).toInt(&ok);
+        if (!ok || decoders < 1) {
+            ErrorReporter::instance().report(
+                QString("Invalid decoder count: %1").arg(parser.value(decodersOption)), LogLevel::Error);
+            return -1;
+        }
+        AppConfig::instance().setDecoderCount(decoders);
+        debug("main", QString("Opening %1 decoders per video").arg(decoders), true);
+    }
+
+    if (parser.isSet(proxyOption)) {
+        AppConfig::instance().setProxyMode(true);
+        debug("main", "Playing from proxy frames when zoomed out", true);
+    }
+
+    if (parser.isSet(streamHistoryOption)) {
+        bool ok;
+        int history = parser.value(streamHistoryOption).toInt(&ok);
+        if (!ok || history < 1) {
+            ErrorReporter::instance().report(
+                QString("Invalid stream history: %1").arg(parser.value(streamHistoryOption)), LogLevel::Error);
+            return -1;
+        }
+        AppConfig::instance().setStreamHistory(history);
+        debug("main", QString("Keeping %1 frames of stream history").arg(history), true);
+    }
+
     QQmlApplicationEngine engine;
 
     // Register AboutHelper for QML
@@ -154,6 +286,8 @@ int main(int argc, char* argv[]) {
     engine.rootContext()->setContextProperty("videoLoader", &videoLoader);
     engine.rootContext()->setContextProperty("compareController", compareController.get());
     engine.rootContext()->setContextProperty("videoController", videoController.get());
+    engine.rootContext()->setContextProperty("thumbnailEngine", videoController->thumbnailEngine().get());
+    engine.addImageProvider("thumbnails", new ThumbnailProvider(videoController->thumbnailEngine()));
 
     // Expose version info to QML
     engine.rootContext()->setContextProperty("APP_NAME", APP_NAME);
@@ -210,10 +344,13 @@ int main(int argc, char* argv[]) {
                 }
             }
 
+            // "-" reads frames from stdin, Y4M unless raw parameters are given
+            bool isStdin = filename == QLatin1String("-");
+
             // Normalize path for various input formats (similar to videoLoader.cpp)
             QString normalizedPath = filename;
             QUrl inUrl = QUrl::fromUserInput(filename);
-            if (inUrl.isLocalFile()) {
+            if (!isStdin && inUrl.isLocalFile()) {
                 normalizedPath = inUrl.toLocalFile();
             }
             // Windows/MSYS fix: handle paths like "/C:/..." or "/c/..."
@@ -229,7 +366,7 @@ int main(int argc, char* argv[]) {
                 }
             }
 
-            if (!QFile::exists(normalizedPath)) {
+            if (!isStdin && !QFile::exists(normalizedPath)) {
                 QString errorMsg = QString("File does not exist: %1").arg(normalizedPath);
                 ErrorReporter::instance().report(errorMsg, LogLevel::Error);
                 return -1;
@@ -242,6 +379,9 @@ int main(int argc, char* argv[]) {
             int width = 0, height = 0;
             double framerate = 25.0;
             QString pixelFormat = VideoFormatUtils::detectFormatFromExtension(filename);
+            if (isStdin) {
+                pixelFormat = paramParts.isEmpty() ? QStringLiteral("Y4M") : QStringLiteral("420P");
+            }
 
             if (VideoFormatUtils::getFormatType(pixelFormat) == FormatType::RAW_YUV) {
                 // This is a raw YUV file that needs explicit parameters
@@ -0,0 +1,85 @@
+import QtQuick 6.0
+import Theme 1.0
+
+// Thumbnails along the timeline with a larger preview of the frame under the mouse
+Item {
+    id: filmstrip
+
+    property int videoId: thumbnailEngine ? thumbnailEngine.primaryVideo : -1
+    property int tileCount: thumbnailEngine ? thumbnailEngine.tileCount : 0
+    property int revision: thumbnailEngine ? thumbnailEngine.revision : 0
+    property int totalFrames: videoController ? videoController.totalFrames : 0
+
+    signal seekRequested(double timeMs)
+
+    function thumbnailSource(frame) {
+        return "image://thumbnails/" + videoId + "/" + frame + "/" + revision;
+    }
+
+    function frameAt(x) {
+        return Math.max(0, Math.min(totalFrames - 1, Math.floor(x / width * totalFrames)));
+    }
+
+    Row {
+        anchors.fill: parent
+
+        Repeater {
+            model: filmstrip.videoId >= 0 ? filmstrip.tileCount : 0
+
+            Image {
+                width: filmstrip.width / filmstrip.tileCount
+                height: filmstrip.height
+                fillMode: Image.PreserveAspectCrop
+                clip: true
+                cache: false
+                asynchronous: true
+                source: filmstrip.thumbnailSource(Math.floor(index * filmstrip.totalFrames / filmstrip.tileCount))
+            }
+        }
+    }
+
+    MouseArea {
+        id: hoverArea
+        anchors.fill: parent
+        hoverEnabled: true
+        onClicked: mouse => {
+            if (videoController && videoController.duration > 0) {
+                filmstrip.seekRequested(mouse.x / width * videoController.duration);
+            }
+        }
+    }
+
+    Rectangle {
+        id: hoverPreview
+        visible: hoverArea.containsMouse && filmstrip.totalFrames > 0
+        width: Theme.thumbnailPreviewWidth
+        height: previewImage.implicitWidth > 0 ? width * previewImage.implicitHeight / previewImage.implicitWidth + 4 : width * 9 / 16
+        x: Math.max(0, Math.min(filmstrip.width - width, hoverArea.mouseX - width / 2))
+        y: -height - Theme.spacingSmall
+        z: 10
+        color: "black"
+        border.color: Theme.borderColor
+        border.width: 1
+        radius: 4
+
+        Image {
+            id: previewImage
+            anchors.fill: parent
+            anchors.margins: 2
+            fillMode: Image.PreserveAspectFit
+            cache: false
+            source: hoverPreview.visible ? filmstrip.thumbnailSource(filmstrip.frameAt(hoverArea.mouseX)) : ""
+        }
+
+        Text {
+            anchors.bottom: parent.bottom
+            anchors.horizontalCenter: parent.horizontalCenter
+            anchors.bottomMargin: Theme.spacingSmall
+            color: "white"
+            style: Text.Outline
+            font.family: Theme.fontFamily
+            font.pixelSize: Theme.fontSizeSmall
+            text: "Frame: " + filmstrip.frameAt(hoverArea.mouseX)
+        }
+    }
+}
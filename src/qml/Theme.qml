@@ -46,6 +46,10 @@ QtObject {
     property int sliderHandleSize: Math.round(16 * scaleFactor)
     property int sliderHeight: Math.round(24 * scaleFactor)
 
+    // Timeline filmstrip
+    property int filmstripHeight: Math.round(32 * scaleFactor)
+    property int thumbnailPreviewWidth: Math.round(192 * scaleFactor)
+
     // Icon sizes
     property int iconSize: Math.round(24 * scaleFactor)
 
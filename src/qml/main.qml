@@ -843,6 +843,32 @@ ApplicationWindow {
                     }
                 }
 
+                // Thumbnail filmstrip, lined up with the time slider below
+                RowLayout {
+                    Layout.fillWidth: true
+                    Layout.leftMargin: 10
+                    Layout.rightMargin: 10
+                    Layout.topMargin: Theme.spacingSmall
+                    visible: thumbnailEngine && thumbnailEngine.primaryVideo >= 0 && thumbnailEngine.tileCount > 0
+
+                    Item {
+                        Layout.preferredWidth: 60
+                    }
+
+                    Filmstrip {
+                        Layout.fillWidth: true
+                        Layout.preferredHeight: Theme.filmstripHeight
+                        onSeekRequested: timeMs => {
+                            videoController.seekTo(timeMs);
+                            keyHandler.forceActiveFocus();
+                        }
+                    }
+
+                    Item {
+                        Layout.preferredWidth: 60
+                    }
+                }
+
                 // Time display with slider
                 RowLayout {
                     Layout.fillWidth: true
@@ -986,6 +1012,9 @@ ApplicationWindow {
                         id: totalTimeText
                         Layout.preferredWidth: 60
                         text: {
+                            if (videoController && videoController.isLive) {
+                                return "LIVE";
+                            }
                             if (videoController) {
                                 var totalSeconds = Math.floor(videoController.duration / 1000);
                                 var totalMin = Math.floor(totalSeconds / 60);
@@ -3,11 +3,30 @@
 #include "utils/debugManager.h"
 #include "utils/errorReporter.h"
 
-DiffRenderer::DiffRenderer(QObject* parent, std::shared_ptr<FrameMeta> metaPtr) :
+DiffRenderer::DiffRenderer(QObject* parent, std::shared_ptr<FrameMeta> metaPtr, std::shared_ptr<FrameMeta> metaPtr2) :
     QObject(parent),
-    m_metaPtr(metaPtr) {
+    m_metaPtr(metaPtr),
+    m_metaPtr2(metaPtr2 ? metaPtr2 : metaPtr) {
 }
 
+namespace {
+// Packed 4:2:2 frames go up whole as two-channel pixels, the shader reads Y from lumaChannel()
+QRhiTexture::Format lumaFormat(const FrameMeta& meta) {
+    return meta.isPacked() ? QRhiTexture::RG8 : QRhiTexture::R8;
+}
+
+int lumaChannel(const FrameMeta& meta) {
+    return meta.format() == AV_PIX_FMT_UYVY422 ? 1 : 0;
+}
+
+QRhiTextureSubresourceUploadDescription lumaUpload(const FrameData* frame, const FrameMeta& meta) {
+    QRhiTextureSubresourceUploadDescription sd(frame->yPtr(), frame->yStride() * meta.yHeight());
+    sd.setDataStride(frame->yStride());
+    sd.setSourceSize(QSize(meta.yWidth(), meta.yHeight()));
+    return sd;
+}
+} // namespace
+
 DiffRenderer::~DiffRenderer() = default;
 
 void DiffRenderer::initialize(QRhi* rhi, QRhiRenderPassDescriptor* rp) {
@@ -24,19 +43,19 @@ void DiffRenderer::initialize(QRhi* rhi, QRhiRenderPassDescriptor* rp) {
     }
 
     // Create YUV textures
-    m_yTex1.reset(m_rhi->newTexture(QRhiTexture::R8, QSize(m_metaPtr->yWidth(), m_metaPtr->yHeight())));
-    m_yTex2.reset(m_rhi->newTexture(QRhiTexture::R8, QSize(m_metaPtr->yWidth(), m_metaPtr->yHeight())));
+    m_yTex1.reset(m_rhi->newTexture(lumaFormat(*m_metaPtr), QSize(m_metaPtr->yWidth(), m_metaPtr->yHeight())));
+    m_yTex2.reset(m_rhi->newTexture(lumaFormat(*m_metaPtr2), QSize(m_metaPtr->yWidth(), m_metaPtr->yHeight())));
     m_yTex1->create();
     m_yTex2->create();
 
     // Diff configuration buffer
-    m_diffConfig.reset(m_rhi->newBuffer(QRhiBuffer::Dynamic, QRhiBuffer::UniformBuffer, sizeof(int) * 4));
+    m_diffConfig.reset(m_rhi->newBuffer(QRhiBuffer::Dynamic, QRhiBuffer::UniformBuffer, sizeof(int) * 8));
     m_diffConfig->create();
 
     // Set default configuration
     setDiffConfig(0, 4.0f, 0); // Default grey mode, 4x multiplier, direct subtraction
 
-    m_resizeParams.reset(m_rhi->newBuffer(QRhiBuffer::Dynamic, QRhiBuffer::UniformBuffer, sizeof(float) * 4));
+    m_resizeParams.reset(m_rhi->newBuffer(QRhiBuffer::Dynamic, QRhiBuffer::UniformBuffer, sizeof(float) * 6));
     m_resizeParams->create();
 
     // Load shaders
@@ -110,15 +129,21 @@ void DiffRenderer::setDiffConfig(int displayMode, float diffMultiplier, int diff
         int displayMode;
         float diffMultiplier;
         int diffMethod;
-        int padding;
+        int lumaChannel1;
+        int lumaChannel2;
+        int padding[3];
     };
-    DiffConfig dc = {displayMode, diffMultiplier, diffMethod, 0};
+    DiffConfig dc = {
+        displayMode, diffMultiplier, diffMethod, lumaChannel(*m_metaPtr), lumaChannel(*m_metaPtr2), {0, 0, 0}};
     m_diffConfigBatch = m_rhi->nextResourceUpdateBatch();
     m_diffConfigBatch->updateDynamicBuffer(m_diffConfig.get(), 0, sizeof(dc), &dc);
 }
 
 void DiffRenderer::uploadFrame(FrameData* frame1, FrameData* frame2) {
-    if (!frame1 || !frame2 || !frame1->yPtr() || !frame2->yPtr()) {
+    // Both frames stay pinned until their planes are copied into the upload batch
+    FramePin pin1(frame1, frame1 ? frame1->pts() : -1);
+    FramePin pin2(frame2, frame2 ? frame2->pts() : -1);
+    if (!pin1 || !pin2 || !frame1->yPtr() || !frame2->yPtr()) {
         ErrorReporter::instance().report("uploadFrame called with invalid frame", LogLevel::Error);
         emit rendererError();
         return;
@@ -142,11 +167,7 @@ void DiffRenderer::uploadFrame(FrameData* frame1, FrameData* frame2) {
     }
 
     QRhiTextureUploadDescription yDesc1;
-    {
-        QRhiTextureSubresourceUploadDescription sd(frame1->yPtr(), m_metaPtr->yWidth() * m_metaPtr->yHeight());
-        sd.setDataStride(m_metaPtr->yWidth());
-        yDesc1.setEntries({{0, 0, sd}});
-    }
+    yDesc1.setEntries({{0, 0, lumaUpload(frame1, *m_metaPtr)}});
 
     if (!m_yTex1.get() || !frame1->yPtr()) {
         ErrorReporter::instance().report("Invalid parameters for uploading Y texture", LogLevel::Error);
@@ -169,11 +190,7 @@ void DiffRenderer::uploadFrame(FrameData* frame1, FrameData* frame2) {
     m_frameBatch->uploadTexture(m_yTex1.get(), yDesc1);
 
     QRhiTextureUploadDescription yDesc2;
-    {
-        QRhiTextureSubresourceUploadDescription sd(frame2->yPtr(), m_metaPtr->yWidth() * m_metaPtr->yHeight());
-        sd.setDataStride(m_metaPtr->yWidth());
-        yDesc2.setEntries({{0, 0, sd}});
-    }
+    yDesc2.setEntries({{0, 0, lumaUpload(frame2, *m_metaPtr2)}});
     m_frameBatch->uploadTexture(m_yTex2.get(), yDesc2);
 
     emit batchIsFull();
@@ -228,9 +245,11 @@ void DiffRenderer::renderFrame(QRhiCommandBuffer* cb, const QRect& viewport, QRh
         struct ResizeParams {
             float scaleX, scaleY;
             float offsetX, offsetY;
+            float texScaleX, texScaleY;
         };
 
-        ResizeParams rp{scaleX, scaleY, offsetX, offsetY};
+        // Compared frames are never proxies, the whole texture is sampled
+        ResizeParams rp{scaleX, scaleY, offsetX, offsetY, 1.0f, 1.0f};
 
         m_resizeParamsBatch = m_rhi->nextResourceUpdateBatch();
         m_resizeParamsBatch->updateDynamicBuffer(m_resizeParams.get(), 0, sizeof(rp), &rp);
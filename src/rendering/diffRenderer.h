@@ -9,7 +9,7 @@
 class DiffRenderer : public QObject {
     Q_OBJECT
   public:
-    DiffRenderer(QObject* parent, std::shared_ptr<FrameMeta> metaPtr);
+    DiffRenderer(QObject* parent, std::shared_ptr<FrameMeta> metaPtr, std::shared_ptr<FrameMeta> metaPtr2);
     ~DiffRenderer();
 
     void initialize(QRhi* rhi, QRhiRenderPassDescriptor* rp);
@@ -28,11 +28,13 @@ class DiffRenderer : public QObject {
 
   public:
     std::shared_ptr<FrameMeta> getFrameMeta() const { return m_metaPtr; }
+    std::shared_ptr<FrameMeta> getFrameMeta2() const { return m_metaPtr2; }
     uint64_t getCurrentPts1() const { return m_currentPts1; }
     uint64_t getCurrentPts2() const { return m_currentPts2; }
 
   private:
     std::shared_ptr<FrameMeta> m_metaPtr;
+    std::shared_ptr<FrameMeta> m_metaPtr2; // Second video, same dimensions but possibly another layout
     uint64_t m_currentPts1 = 0;
     uint64_t m_currentPts2 = 0;
     QRhi* m_rhi = nullptr;
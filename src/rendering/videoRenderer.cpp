@@ -3,6 +3,15 @@
 #include "utils/debugManager.h"
 #include "utils/errorReporter.h"
 
+namespace {
+// Proxies go down to a quarter of the source size
+constexpr int kMaxProxyShift = 2;
+
+int proxySize(int size, int shift) {
+    return (size + (1 << shift) - 1) >> shift;
+}
+} // namespace
+
 VideoRenderer::VideoRenderer(QObject* parent, std::shared_ptr<FrameMeta> metaPtr) :
     QObject(parent),
     m_metaPtr(metaPtr) {
@@ -24,9 +33,21 @@ void VideoRenderer::initialize(QRhi* rhi, QRhiRenderPassDescriptor* rp) {
     }
 
     // Create YUV textures
-    m_yTex.reset(m_rhi->newTexture(QRhiTexture::R8, QSize(m_metaPtr->yWidth(), m_metaPtr->yHeight())));
-    m_uTex.reset(m_rhi->newTexture(QRhiTexture::R8, QSize(m_metaPtr->uvWidth(), m_metaPtr->uvHeight())));
-    m_vTex.reset(m_rhi->newTexture(QRhiTexture::R8, QSize(m_metaPtr->uvWidth(), m_metaPtr->uvHeight())));
+    if (m_metaPtr->isPacked()) {
+        // Each RGBA texel holds one packed pixel pair, chroma textures only fill their bindings
+        m_yTex.reset(m_rhi->newTexture(QRhiTexture::RGBA8, QSize(m_metaPtr->uvWidth(), m_metaPtr->yHeight())));
+        m_uTex.reset(m_rhi->newTexture(QRhiTexture::R8, QSize(1, 1)));
+        m_vTex.reset(m_rhi->newTexture(QRhiTexture::R8, QSize(1, 1)));
+    } else if (m_metaPtr->isSemiPlanar()) {
+        // Interleaved chroma goes up as one two-channel texture, V stays a placeholder for the binding
+        m_yTex.reset(m_rhi->newTexture(QRhiTexture::R8, QSize(m_metaPtr->yWidth(), m_metaPtr->yHeight())));
+        m_uTex.reset(m_rhi->newTexture(QRhiTexture::RG8, QSize(m_metaPtr->uvWidth(), m_metaPtr->uvHeight())));
+        m_vTex.reset(m_rhi->newTexture(QRhiTexture::R8, QSize(1, 1)));
+    } else {
+        m_yTex.reset(m_rhi->newTexture(QRhiTexture::R8, QSize(m_metaPtr->yWidth(), m_metaPtr->yHeight())));
+        m_uTex.reset(m_rhi->newTexture(QRhiTexture::R8, QSize(m_metaPtr->uvWidth(), m_metaPtr->uvHeight())));
+        m_vTex.reset(m_rhi->newTexture(QRhiTexture::R8, QSize(m_metaPtr->uvWidth(), m_metaPtr->uvHeight())));
+    }
     m_yTex->create();
     m_uTex->create();
     m_vTex->create();
@@ -37,7 +58,7 @@ void VideoRenderer::initialize(QRhi* rhi, QRhiRenderPassDescriptor* rp) {
 
     setColorParams(m_metaPtr->colorSpace(), m_metaPtr->colorRange());
 
-    m_resizeParams.reset(m_rhi->newBuffer(QRhiBuffer::Dynamic, QRhiBuffer::UniformBuffer, sizeof(float) * 4));
+    m_resizeParams.reset(m_rhi->newBuffer(QRhiBuffer::Dynamic, QRhiBuffer::UniformBuffer, sizeof(float) * 6));
     m_resizeParams->create();
 
     // Load shaders
@@ -108,11 +129,26 @@ QByteArray VideoRenderer::loadShaderSource(const QString& path) {
     return f.readAll();
 }
 
+int VideoRenderer::chromaLayout() const {
+    switch (m_metaPtr->format()) {
+    case AV_PIX_FMT_NV12:
+        return 1;
+    case AV_PIX_FMT_NV21:
+        return 2;
+    case AV_PIX_FMT_UYVY422:
+        return 3;
+    case AV_PIX_FMT_YUYV422:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
 void VideoRenderer::setColorParams(AVColorSpace space, AVColorRange range) {
     struct ColorParams {
-        int colorSpace, colorRange, componentDisplayMode, padding;
+        int colorSpace, colorRange, componentDisplayMode, chromaLayout;
     };
-    ColorParams cp = {space, range, m_componentDisplayMode, 0};
+    ColorParams cp = {space, range, m_componentDisplayMode, chromaLayout()};
     m_colorParamsBatch = m_rhi->nextResourceUpdateBatch();
     m_colorParamsBatch->updateDynamicBuffer(m_colorParams.get(), 0, sizeof(cp), &cp);
 }
@@ -120,15 +156,17 @@ void VideoRenderer::setColorParams(AVColorSpace space, AVColorRange range) {
 void VideoRenderer::setComponentDisplayMode(int mode) {
     m_componentDisplayMode = mode;
     struct ColorParams {
-        int colorSpace, colorRange, componentDisplayMode, padding;
+        int colorSpace, colorRange, componentDisplayMode, chromaLayout;
     };
-    ColorParams cp = {m_metaPtr->colorSpace(), m_metaPtr->colorRange(), mode, 0};
+    ColorParams cp = {m_metaPtr->colorSpace(), m_metaPtr->colorRange(), mode, chromaLayout()};
     m_colorParamsBatch = m_rhi->nextResourceUpdateBatch();
     m_colorParamsBatch->updateDynamicBuffer(m_colorParams.get(), 0, sizeof(cp), &cp);
 }
 
 void VideoRenderer::uploadFrame(FrameData* frame) {
-    if (!frame || !frame->yPtr() || !frame->uPtr() || !frame->vPtr()) {
+    // The upload descriptions copy the planes, the frame only has to stay pinned while they are built
+    FramePin pin(frame, frame ? frame->pts() : -1);
+    if (!pin || !frame->yPtr() || !frame->uPtr() || !frame->vPtr()) {
         ErrorReporter::instance().report("Invalid frame data provided to VideoRenderer::uploadFrame", LogLevel::Error);
         emit rendererError();
         return;
@@ -140,7 +178,8 @@ void VideoRenderer::uploadFrame(FrameData* frame) {
         return;
     }
 
-    m_currentFrame = frame;
+    m_currentFrame.store(frame, std::memory_order_relaxed);
+    m_currentPts.store(frame->pts(), std::memory_order_relaxed);
     m_frameBatch = m_rhi->nextResourceUpdateBatch();
 
     if (!m_frameBatch) {
@@ -149,10 +188,30 @@ void VideoRenderer::uploadFrame(FrameData* frame) {
         return;
     }
 
+    // Proxy frames only replace the top left part of each texture, the shader samples just that part
+    int shift = frame->proxyShift();
+    if (shift != m_proxyShift) {
+        m_proxyShift = shift;
+        m_windowAspect = 0.0f;
+    }
+    int yWidth = proxySize(m_metaPtr->yWidth(), shift);
+    int yHeight = proxySize(m_metaPtr->yHeight(), shift);
+    int uvWidth = proxySize(m_metaPtr->uvWidth(), shift);
+    int uvHeight = proxySize(m_metaPtr->uvHeight(), shift);
+    // Rows are padded in the slot, proxies keep the full resolution strides too
+    int yStride = frame->yStride();
+    int uvStride = frame->uvStride();
+
     QRhiTextureUploadDescription yDesc;
-    {
-        QRhiTextureSubresourceUploadDescription sd(frame->yPtr(), m_metaPtr->yWidth() * m_metaPtr->yHeight());
-        sd.setDataStride(m_metaPtr->yWidth());
+    if (m_metaPtr->isPacked()) {
+        QRhiTextureSubresourceUploadDescription sd(frame->yPtr(), yStride * m_metaPtr->yHeight());
+        sd.setDataStride(yStride);
+        sd.setSourceSize(QSize(m_metaPtr->uvWidth(), m_metaPtr->yHeight()));
+        yDesc.setEntries({{0, 0, sd}});
+    } else {
+        QRhiTextureSubresourceUploadDescription sd(frame->yPtr(), yStride * yHeight);
+        sd.setDataStride(yStride);
+        sd.setSourceSize(QSize(yWidth, yHeight));
         yDesc.setEntries({{0, 0, sd}});
     }
 
@@ -176,21 +235,35 @@ void VideoRenderer::uploadFrame(FrameData* frame) {
 
     m_frameBatch->uploadTexture(m_yTex.get(), yDesc);
 
-    QRhiTextureUploadDescription uDesc;
-    {
-        QRhiTextureSubresourceUploadDescription sd(frame->uPtr(), m_metaPtr->uvWidth() * m_metaPtr->uvHeight());
-        sd.setDataStride(m_metaPtr->uvWidth());
-        uDesc.setEntries({{0, 0, sd}});
-    }
-    m_frameBatch->uploadTexture(m_uTex.get(), uDesc);
-
-    QRhiTextureUploadDescription vDesc;
-    {
-        QRhiTextureSubresourceUploadDescription sd(frame->vPtr(), m_metaPtr->uvWidth() * m_metaPtr->uvHeight());
-        sd.setDataStride(m_metaPtr->uvWidth());
-        vDesc.setEntries({{0, 0, sd}});
+    // Packed frames carry their chroma inside the Y texture
+    if (m_metaPtr->isSemiPlanar()) {
+        QRhiTextureUploadDescription uvDesc;
+        {
+            QRhiTextureSubresourceUploadDescription sd(frame->uPtr(), uvStride * uvHeight);
+            sd.setDataStride(uvStride);
+            sd.setSourceSize(QSize(uvWidth, uvHeight));
+            uvDesc.setEntries({{0, 0, sd}});
+        }
+        m_frameBatch->uploadTexture(m_uTex.get(), uvDesc);
+    } else if (!m_metaPtr->isPacked()) {
+        QRhiTextureUploadDescription uDesc;
+        {
+            QRhiTextureSubresourceUploadDescription sd(frame->uPtr(), uvStride * uvHeight);
+            sd.setDataStride(uvStride);
+            sd.setSourceSize(QSize(uvWidth, uvHeight));
+            uDesc.setEntries({{0, 0, sd}});
+        }
+        m_frameBatch->uploadTexture(m_uTex.get(), uDesc);
+
+        QRhiTextureUploadDescription vDesc;
+        {
+            QRhiTextureSubresourceUploadDescription sd(frame->vPtr(), uvStride * uvHeight);
+            sd.setDataStride(uvStride);
+            sd.setSourceSize(QSize(uvWidth, uvHeight));
+            vDesc.setEntries({{0, 0, sd}});
+        }
+        m_frameBatch->uploadTexture(m_vTex.get(), vDesc);
     }
-    m_frameBatch->uploadTexture(m_vTex.get(), vDesc);
 
     emit batchIsFull();
 }
@@ -241,17 +314,30 @@ void VideoRenderer::renderFrame(QRhiCommandBuffer* cb, const QRect& viewport, QR
             offsetY = (m_centerY - 0.5f) * 2.0f * scaleY;
         }
 
+        m_displayScaleX = scaleX;
+
         struct ResizeParams {
             float scaleX, scaleY;
             float offsetX, offsetY;
+            float texScaleX, texScaleY;
         };
 
-        ResizeParams rp{scaleX, scaleY, offsetX, offsetY};
+        float texScaleX = float(proxySize(m_metaPtr->yWidth(), m_proxyShift)) / m_metaPtr->yWidth();
+        float texScaleY = float(proxySize(m_metaPtr->yHeight(), m_proxyShift)) / m_metaPtr->yHeight();
+        ResizeParams rp{scaleX, scaleY, offsetX, offsetY, texScaleX, texScaleY};
 
         m_resizeParamsBatch = m_rhi->nextResourceUpdateBatch();
         m_resizeParamsBatch->updateDynamicBuffer(m_resizeParams.get(), 0, sizeof(rp), &rp);
     }
 
+    // Zoomed out far enough, playback can decode at a fraction of the source size without losing detail
+    float screenPixelsPerSample = viewport.width() * m_displayScaleX / m_metaPtr->yWidth();
+    int proxyLimit = 0;
+    while (proxyLimit < kMaxProxyShift && screenPixelsPerSample * (2 << proxyLimit) <= 1.0f) {
+        ++proxyLimit;
+    }
+    m_proxyLimit.store(proxyLimit, std::memory_order_relaxed);
+
     if (m_resizeParamsBatch) {
         cb->resourceUpdate(m_resizeParamsBatch);
         m_resizeParamsBatch = nullptr;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QRectF>
+#include <atomic>
 #include <memory>
 #include "frames/frameData.h"
 #include "frames/frameMeta.h"
@@ -29,11 +30,16 @@ class VideoRenderer : public QObject {
 
   public:
     std::shared_ptr<FrameMeta> getFrameMeta() const { return m_metaPtr; }
-    FrameData* getCurrentFrame() const { return m_currentFrame; }
+    // The frame last uploaded and its pts, pin the frame with that pts before reading it again
+    FrameData* getCurrentFrame() const { return m_currentFrame.load(std::memory_order_relaxed); }
+    int64_t getCurrentPts() const { return m_currentPts.load(std::memory_order_relaxed); }
+    // Largest proxy shift that still leaves a decoded pixel for every screen pixel, safe to read from other threads
+    int proxyLimit() const { return m_proxyLimit.load(std::memory_order_relaxed); }
 
   private:
     std::shared_ptr<FrameMeta> m_metaPtr;
-    FrameData* m_currentFrame = nullptr;
+    std::atomic<FrameData*> m_currentFrame = nullptr;
+    std::atomic<int64_t> m_currentPts = -1;
     QRhi* m_rhi = nullptr;
     float m_zoom = 1.0f;
     float m_centerX = 0.5f;
@@ -48,6 +54,9 @@ class VideoRenderer : public QObject {
     std::unique_ptr<QRhiShaderResourceBindings> m_resourceBindings;
     std::unique_ptr<QRhiBuffer> m_vbuf;
     float m_windowAspect = 0;
+    float m_displayScaleX = 0; // Horizontal scale of the video in the viewport, zoom included
+    int m_proxyShift = 0;      // Proxy shift of the frame in the textures
+    std::atomic<int> m_proxyLimit = 0;
     int m_componentDisplayMode = 0; // 0=RGB, 1=Y only, 2=U only, 3=V only
 
     QRhiResourceUpdateBatch* m_initBatch = nullptr;
@@ -56,4 +65,5 @@ class VideoRenderer : public QObject {
     QRhiResourceUpdateBatch* m_resizeParamsBatch = nullptr;
 
     QByteArray loadShaderSource(const QString& path);
+    int chromaLayout() const; // 0=planar, 1=NV12, 2=NV21, 3=UYVY, 4=YUYV
 };
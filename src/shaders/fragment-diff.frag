@@ -12,7 +12,8 @@ layout(binding = 4) uniform DiffConfigParams {
     int displayMode;    // 0=Grayscale Classic, 1=Heatmap, 2=Binary
     float diffMultiplier; // diff multiplier
     int diffMethod;     // 0=Direct Subtraction, 1=Squared Difference, 2=Normalized, 3=Absolute Difference
-    int padding;        // Alignment to 16-byte boundary
+    int lumaChannel1;   // Channel holding Y, 1 for packed UYVY frames and 0 otherwise
+    int lumaChannel2;
 };
 
 // Viridis color mapping function
@@ -29,8 +30,8 @@ vec3 viridis(float t) {
 void main() {
     vec2 texCoord = v_texCoord;
 
-    float y1 = texture(y_tex_frame1, texCoord).r;
-    float y2 = texture(y_tex_frame2, texCoord).r;
+    float y1 = texture(y_tex_frame1, texCoord)[lumaChannel1];
+    float y2 = texture(y_tex_frame2, texCoord)[lumaChannel2];
 
     // Calculate difference based on configuration
     float diff;
@@ -3,7 +3,7 @@
 layout(location = 0) in vec2 v_texCoord;
 layout(location = 0) out vec4 fragColor;
 
-layout(binding = 1) uniform sampler2D y_tex;
+layout(binding = 1) uniform sampler2D y_tex; // RGBA pixel pairs for packed 4:2:2
 layout(binding = 2) uniform sampler2D u_tex;
 layout(binding = 3) uniform sampler2D v_tex;
 
@@ -13,14 +13,39 @@ layout(binding = 4) uniform ColorSpaceParams {
                     // 10=BT.2020_CL
     int colorRange; // AVColorRange: 1=MPEG (16-235), 2=JPEG (0-255)
     int componentDisplayMode; // 0=RGB, 1=Y only, 2=U only, 3=V only
-    int padding; // Alignment to 16-byte boundary
+    int chromaLayout; // 0=planar U/V, 1=NV12 (UV pairs in u_tex), 2=NV21 (VU pairs in u_tex),
+                      // 3=UYVY, 4=YUYV (whole frame in y_tex)
 };
 
 void main() {
     vec2 texCoord = v_texCoord;
-    float y = texture(y_tex, texCoord).r;
-    float u = texture(u_tex, texCoord).r;
-    float v = texture(v_tex, texCoord).r;
+    float y;
+    float u;
+    float v;
+    if (chromaLayout >= 3) {
+        // One texel is a pixel pair sharing U and V, the column parity picks its Y sample
+        vec4 pair = texture(y_tex, texCoord);
+        bool odd = mod(floor(texCoord.x * float(textureSize(y_tex, 0).x * 2)), 2.0) >= 1.0;
+        if (chromaLayout == 3) {
+            y = odd ? pair.a : pair.g;
+            u = pair.r;
+            v = pair.b;
+        } else {
+            y = odd ? pair.b : pair.r;
+            u = pair.g;
+            v = pair.a;
+        }
+    } else if (chromaLayout == 0) {
+        y = texture(y_tex, texCoord).r;
+        u = texture(u_tex, texCoord).r;
+        v = texture(v_tex, texCoord).r;
+    } else {
+        // Semi-planar chroma is a single RG texture, NV21 stores V first
+        y = texture(y_tex, texCoord).r;
+        vec2 uv = texture(u_tex, texCoord).rg;
+        u = chromaLayout == 2 ? uv.g : uv.r;
+        v = chromaLayout == 2 ? uv.r : uv.g;
+    }
 
     // Normalize based on color range
     if (colorRange == 1) {
@@ -8,9 +8,11 @@ layout(location = 0) out vec2 v_texCoord;
 layout(std140, binding = 5) uniform ResizeParams {
     vec2 u_scale;
     vec2 u_offset;
+    // Proxy frames only fill the top left part of the textures
+    vec2 u_texScale;
 };
 
 void main() {
     gl_Position = vec4(position * u_scale + u_offset, 0.0, 1.0);
-    v_texCoord = texCoord;
+    v_texCoord = texCoord * u_texScale;
 }
\ No newline at end of file
@@ -21,12 +21,13 @@ DiffWindow::DiffWindow(QQuickItem* parent) :
 }
 
 void DiffWindow::initialize(std::shared_ptr<FrameMeta> metaPtr,
+                            std::shared_ptr<FrameMeta> metaPtr2,
                             std::shared_ptr<FrameQueue> queuePtr1,
                             std::shared_ptr<FrameQueue> queuePtr2) {
     m_frameMeta = metaPtr; // Store the frameMeta for OSD access
     m_frameQueue1 = queuePtr1;
     m_frameQueue2 = queuePtr2;
-    m_renderer = new DiffRenderer(this, metaPtr);
+    m_renderer = new DiffRenderer(this, metaPtr, metaPtr2);
 
     // Set aspect ratio based on actual frame dimensions from frameMeta
     if (metaPtr && metaPtr->yHeight() > 0) {
@@ -141,12 +142,20 @@ QVariant DiffWindow::getDiffValue(int x, int y) const {
     FrameData* frame1 = m_frameQueue1->getHeadFrame(pts1);
     FrameData* frame2 = m_frameQueue2->getHeadFrame(pts2);
     auto meta = m_renderer->getFrameMeta();
+    auto meta2 = m_renderer->getFrameMeta2();
 
-    if (!frame1 || !frame2 || !meta) {
+    if (!frame1 || !frame2 || !meta || !meta2) {
         ErrorReporter::instance().report("Invalid frame data provided to DiffWindow::getDiffValue", LogLevel::Error);
         return QVariant();
     }
 
+    // The frames may be replaced before they are read, then there is no value to show
+    FramePin pin1(frame1, static_cast<int64_t>(pts1));
+    FramePin pin2(frame2, static_cast<int64_t>(pts2));
+    if (!pin1 || !pin2) {
+        return QVariant();
+    }
+
     int yW = meta->yWidth();
     int yH = meta->yHeight();
     if (x < 0 || y < 0 || x >= yW || y >= yH) {
@@ -162,12 +171,21 @@ QVariant DiffWindow::getDiffValue(int x, int y) const {
         return QVariant();
     }
 
+    // Packed 4:2:2 frames keep Y in every other byte, at odd offsets for UYVY
+    auto lumaIndex = [&](const FrameData& frame, const FrameMeta& frameMeta) {
+        int row = y * frame.yStride();
+        if (!frameMeta.isPacked()) {
+            return row + x;
+        }
+        return row + x * 2 + (frameMeta.format() == AV_PIX_FMT_UYVY422 ? 1 : 0);
+    };
+
     // Get Y values from both frames with bounds checking
     int y1Val = 0;
     int y2Val = 0;
     try {
-        y1Val = y1Ptr[y * yW + x];
-        y2Val = y2Ptr[y * yW + x];
+        y1Val = y1Ptr[lumaIndex(*frame1, *meta)];
+        y2Val = y2Ptr[lumaIndex(*frame2, *meta2)];
     } catch (...) {
         ErrorReporter::instance().report("Exception caught when accessing pixel data", LogLevel::Error);
         return QVariant();
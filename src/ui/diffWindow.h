@@ -32,6 +32,7 @@ class DiffWindow : public QQuickItem {
     SharedViewProperties* sharedView() const;
     void setSharedView(SharedViewProperties* view);
     void initialize(std::shared_ptr<FrameMeta> metaPtr,
+                    std::shared_ptr<FrameMeta> metaPtr2,
                     std::shared_ptr<FrameQueue> queuePtr1,
                     std::shared_ptr<FrameQueue> queuePtr2);
     DiffRenderer* m_renderer = nullptr;
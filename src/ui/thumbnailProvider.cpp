@@ -0,0 +1,27 @@
+#include "thumbnailProvider.h"
+
+ThumbnailProvider::ThumbnailProvider(std::shared_ptr<ThumbnailEngine> engine) :
+    QQuickImageProvider(QQuickImageProvider::Image),
+    m_engine(std::move(engine)) {}
+
+QImage ThumbnailProvider::requestImage(const QString& id, QSize* size, const QSize& requestedSize) {
+    // The trailing revision only defeats QML's image cache, the tile is picked by video and frame
+    QStringList parts = id.split('/');
+    QImage image;
+    if (m_engine && parts.size() >= 2) {
+        image = m_engine->thumbnail(parts[0].toInt(), parts[1].toLongLong());
+    }
+
+    // Tiles that are not decoded yet stay transparent
+    if (image.isNull()) {
+        image = QImage(1, 1, QImage::Format_RGBA8888);
+        image.fill(Qt::transparent);
+    }
+    if (requestedSize.isValid()) {
+        image = image.scaled(requestedSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+    if (size) {
+        *size = image.size();
+    }
+    return image;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <QQuickImageProvider>
+#include <memory>
+#include "decoder/thumbnailEngine.h"
+
+// Serves filmstrip tiles to QML as image://thumbnails/<video>/<frame>[/<revision>]
+class ThumbnailProvider : public QQuickImageProvider {
+  public:
+    explicit ThumbnailProvider(std::shared_ptr<ThumbnailEngine> engine);
+
+    QImage requestImage(const QString& id, QSize* size, const QSize& requestedSize) override;
+
+  private:
+    std::shared_ptr<ThumbnailEngine> m_engine;
+};
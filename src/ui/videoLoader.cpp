@@ -23,9 +23,11 @@ void VideoLoader::loadVideo(
     bool effectiveForceSoftware = forceSoftware || m_globalForceSoftwareDecoding;
 
     QString path = filePath;
+    // "-" is stdin, not a path
+    bool isStdin = filePath == QLatin1String("-");
     // Robust normalization for various inputs (URL, local path, Windows-specific forms)
     QUrl inUrl = QUrl::fromUserInput(filePath);
-    if (inUrl.isLocalFile()) {
+    if (!isStdin && inUrl.isLocalFile()) {
         path = inUrl.toLocalFile();
     }
     // Windows fix: handle paths like "/C:/..."
@@ -33,7 +35,7 @@ void VideoLoader::loadVideo(
         path.remove(0, 1);
     }
 
-    if (!QFile::exists(path)) {
+    if (!isStdin && !QFile::exists(path)) {
         ErrorReporter::instance().report(QString("File does not exist: %1").arg(path), LogLevel::Error);
         return;
     }
@@ -62,9 +62,9 @@ void VideoWindow::renderFrame() {
 
     // Update frame info
     if (m_renderer && m_frameMeta) {
-        FrameData* currentFrame = m_renderer->getCurrentFrame();
-        if (currentFrame) {
-            int64_t pts = currentFrame->pts();
+        // The slot may hold another frame by now, the renderer remembers what it uploaded
+        int64_t pts = m_renderer->getCurrentPts();
+        if (pts >= 0) {
             AVRational timeBase = m_frameMeta->timeBase();
             double currentTimeMs = pts * av_q2d(timeBase) * 1000.0;
             updateFrameInfo(static_cast<int>(pts), currentTimeMs);
@@ -381,10 +381,26 @@ QVariant VideoWindow::getYUV(int x, int y) const {
     auto meta = m_renderer->getFrameMeta();
     if (!frame || !meta)
         return QVariant();
+    // Nothing to read once the decoder has reused the slot
+    FramePin pin(frame, m_renderer->getCurrentPts());
+    if (!pin)
+        return QVariant();
     int yW = meta->yWidth(), yH = meta->yHeight();
-    int uvW = meta->uvWidth(), uvH = meta->uvHeight();
+    int yStride = frame->yStride(), uvStride = frame->uvStride();
     if (x < 0 || y < 0 || x >= yW || y >= yH)
         return QVariant();
+
+    // A proxy still on screen right after pausing is read at its own resolution, always planar
+    if (int shift = frame->proxyShift()) {
+        const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(meta->format());
+        int px = x >> shift, py = y >> shift;
+        int uvOffset = (py >> desc->log2_chroma_h) * uvStride + (px >> desc->log2_chroma_w);
+        QVariantList result;
+        result << int(frame->yPtr()[py * yStride + px]) << int(frame->uPtr()[uvOffset])
+               << int(frame->vPtr()[uvOffset]);
+        return result;
+    }
+
     AVPixelFormat fmt = meta->format();
     int yVal = 0, uVal = 0, vVal = 0;
 
@@ -394,7 +410,7 @@ QVariant VideoWindow::getYUV(int x, int y) const {
         // YUYV: Y0 U0 Y1 V0 Y2 U1 Y3 V1...
         uint8_t* data = frame->yPtr();
         int pixelPair = x / 2;
-        int offset = (y * yW + pixelPair) * 4;
+        int offset = y * yStride + pixelPair * 4;
         yVal = data[offset + (x % 2) * 2]; // Y0 or Y1
         uVal = data[offset + 1];           // U
         vVal = data[offset + 3];           // V
@@ -404,57 +420,59 @@ QVariant VideoWindow::getYUV(int x, int y) const {
         // UYVY: U0 Y0 V0 Y1 U1 Y2 V1 Y3...
         uint8_t* data = frame->yPtr();
         int pixelPair = x / 2;
-        int offset = (y * yW + pixelPair) * 4;
+        int offset = y * yStride + pixelPair * 4;
         uVal = data[offset];                   // U
         yVal = data[offset + 1 + (x % 2) * 2]; // Y0 or Y1
         vVal = data[offset + 2];               // V
         break;
     }
     case AV_PIX_FMT_NV12: {
-        // NV12: Y plane + UV interleaved plane (converted to YUV420P)
-        yVal = frame->yPtr()[y * yW + x];
+        // NV12: Y plane + UV interleaved plane
+        yVal = frame->yPtr()[y * yStride + x];
         int ux = x / 2, uy = y / 2;
-        uVal = frame->uPtr()[uy * meta->uvWidth() + ux];
-        vVal = frame->vPtr()[uy * meta->uvWidth() + ux];
+        const uint8_t* uv = frame->uPtr() + uy * uvStride + ux * 2;
+        uVal = uv[0];
+        vVal = uv[1];
         break;
     }
     case AV_PIX_FMT_NV21: {
-        // NV21: Y plane + VU interleaved plane (converted to YUV420P)
-        yVal = frame->yPtr()[y * yW + x];
+        // NV21: Y plane + VU interleaved plane
+        yVal = frame->yPtr()[y * yStride + x];
         int ux = x / 2, uy = y / 2;
-        uVal = frame->uPtr()[uy * meta->uvWidth() + ux];
-        vVal = frame->vPtr()[uy * meta->uvWidth() + ux];
+        const uint8_t* vu = frame->uPtr() + uy * uvStride + ux * 2;
+        vVal = vu[0];
+        uVal = vu[1];
         break;
     }
 
     // Handle planar YUV formats
     case AV_PIX_FMT_YUV420P: {
-        yVal = frame->yPtr()[y * yW + x];
+        yVal = frame->yPtr()[y * yStride + x];
         int ux = x / 2, uy = y / 2;
-        uVal = frame->uPtr()[uy * meta->uvWidth() + ux];
-        vVal = frame->vPtr()[uy * meta->uvWidth() + ux];
+        uVal = frame->uPtr()[uy * uvStride + ux];
+        vVal = frame->vPtr()[uy * uvStride + ux];
         break;
     }
     case AV_PIX_FMT_YUV422P: {
-        yVal = frame->yPtr()[y * yW + x];
+        yVal = frame->yPtr()[y * yStride + x];
         int ux = x / 2, uy = y;
-        uVal = frame->uPtr()[uy * meta->uvWidth() + ux];
-        vVal = frame->vPtr()[uy * meta->uvWidth() + ux];
+        uVal = frame->uPtr()[uy * uvStride + ux];
+        vVal = frame->vPtr()[uy * uvStride + ux];
         break;
     }
     case AV_PIX_FMT_YUV444P: {
-        yVal = frame->yPtr()[y * yW + x];
+        yVal = frame->yPtr()[y * yStride + x];
         int ux = x, uy = y;
-        uVal = frame->uPtr()[uy * meta->uvWidth() + ux];
-        vVal = frame->vPtr()[uy * meta->uvWidth() + ux];
+        uVal = frame->uPtr()[uy * uvStride + ux];
+        vVal = frame->vPtr()[uy * uvStride + ux];
         break;
     }
     default: {
         // Default to YUV420P behavior for unknown formats
-        yVal = frame->yPtr()[y * yW + x];
+        yVal = frame->yPtr()[y * yStride + x];
         int ux = x / 2, uy = y / 2;
-        uVal = frame->uPtr()[uy * meta->uvWidth() + ux];
-        vVal = frame->vPtr()[uy * meta->uvWidth() + ux];
+        uVal = frame->uPtr()[uy * uvStride + ux];
+        vVal = frame->vPtr()[uy * uvStride + ux];
         break;
     }
     }
@@ -0,0 +1,90 @@
+#include "allocationCounter.h"
+
+#ifdef YUVIZ_ALLOC_COUNTER
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+thread_local uint64_t t_allocations = 0;
+std::atomic<uint64_t> s_allocations = 0;
+
+void* countedAlloc(std::size_t size) noexcept {
+    ++t_allocations;
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+} // namespace
+
+// Replacements for the global allocation functions, the aligned variants keep the library defaults
+void* operator new(std::size_t size) {
+    if (void* ptr = countedAlloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+bool AllocationCounter::isEnabled() {
+    return true;
+}
+
+uint64_t AllocationCounter::threadAllocations() {
+    return t_allocations;
+}
+
+uint64_t AllocationCounter::totalAllocations() {
+    return s_allocations.load(std::memory_order_relaxed);
+}
+
+#else
+
+bool AllocationCounter::isEnabled() {
+    return false;
+}
+
+uint64_t AllocationCounter::threadAllocations() {
+    return 0;
+}
+
+uint64_t AllocationCounter::totalAllocations() {
+    return 0;
+}
+
+#endif
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+// Counts heap allocations made through operator new, per thread. FFmpeg allocates with av_malloc,
+// which cannot be hooked, so buffers the libraries allocate are not counted.
+// Only active in builds configured with -DYUVIZ_ALLOC_COUNTER=ON, otherwise every count is 0.
+class AllocationCounter {
+  public:
+    static bool isEnabled();
+
+    // Allocations made by the calling thread since it started
+    static uint64_t threadAllocations();
+
+    // Allocations made by all threads since startup
+    static uint64_t totalAllocations();
+};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 class AppConfig {
   public:
     static AppConfig& instance() {
@@ -10,7 +12,32 @@ class AppConfig {
     void setQueueSize(int size) { m_queueSize = size; }
     int getQueueSize() const { return m_queueSize; }
 
+    // Bytes of decoded frames shared by all videos, queue sizes then follow from the frame size
+    void setCacheBudget(int64_t bytes) { m_cacheBudget = bytes; }
+    int64_t getCacheBudget() const { return m_cacheBudget; }
+
+    void setDecodeThreads(int threads) { m_decodeThreads = threads; }
+    int getDecodeThreads() const { return m_decodeThreads; }
+
+    void setGpuUnpack(bool enabled) { m_gpuUnpack = enabled; }
+    bool getGpuUnpack() const { return m_gpuUnpack; }
+
+    void setDecoderCount(int count) { m_decoderCount = count; }
+    int getDecoderCount() const { return m_decoderCount; }
+
+    void setProxyMode(bool enabled) { m_proxyMode = enabled; }
+    bool getProxyMode() const { return m_proxyMode; }
+
+    void setStreamHistory(int frames) { m_streamHistory = frames; }
+    int getStreamHistory() const { return m_streamHistory; }
+
   private:
     AppConfig() = default;
-    int m_queueSize = 50; // Default queue size
+    int m_queueSize = 50;    // Default queue size
+    int64_t m_cacheBudget = 0; // 0 keeps the fixed queue size
+    int m_decodeThreads = 0; // 0 lets the decoder pick the thread count
+    bool m_gpuUnpack = false; // Keep raw YUYV/UYVY packed and unpack it in the shader
+    int m_decoderCount = 1;   // Decoder instances per video, each parked in its own timeline region
+    bool m_proxyMode = false; // Play zoomed out compressed video from downscaled frames
+    int m_streamHistory = 100; // Frames of stdin or pipe input kept for stepping back
 };
@@ -83,6 +83,83 @@ static inline uint64_t sumSquaredDiff(const uint8_t* __restrict p1, const uint8_
     return s0 + s1 + s2 + s3;
 }
 
+// Sum of squared differences over samples spaced step1/step2 bytes apart, used for interleaved layouts
+static inline uint64_t sumSquaredDiffStrided(
+    const uint8_t* __restrict p1, size_t step1, const uint8_t* __restrict p2, size_t step2, size_t count) {
+    uint64_t s0 = 0, s1 = 0;
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        int d0 = int(p1[i * step1]) - int(p2[i * step2]);
+        s0 += uint64_t(d0 * d0);
+        int d1 = int(p1[(i + 1) * step1]) - int(p2[(i + 1) * step2]);
+        s1 += uint64_t(d1 * d1);
+    }
+    for (; i < count; ++i) {
+        int d = int(p1[i * step1]) - int(p2[i * step2]);
+        s0 += uint64_t(d * d);
+    }
+    return s0 + s1;
+}
+
+namespace {
+// First sample of a Y, U or V plane, the distance in bytes between neighbouring samples and between rows
+struct PlaneSamples {
+    const uint8_t* data = nullptr;
+    size_t step = 1;
+    size_t stride = 0;
+};
+
+// Resolves where the Y, U and V samples of a frame live for the layout its format is stored in
+void samplePlanes(const FrameData* frame, const FrameMeta* meta, PlaneSamples planes[3]) {
+    const uint8_t* y = frame->yPtr();
+    const uint8_t* uv = frame->uPtr();
+    size_t yStride = static_cast<size_t>(frame->yStride());
+    size_t uvStride = static_cast<size_t>(frame->uvStride());
+    switch (meta->format()) {
+    case AV_PIX_FMT_NV12:
+        planes[0] = {y, 1, yStride};
+        planes[1] = {uv, 2, uvStride};
+        planes[2] = {uv ? uv + 1 : nullptr, 2, uvStride};
+        break;
+    case AV_PIX_FMT_NV21:
+        planes[0] = {y, 1, yStride};
+        planes[1] = {uv ? uv + 1 : nullptr, 2, uvStride};
+        planes[2] = {uv, 2, uvStride};
+        break;
+    case AV_PIX_FMT_UYVY422:
+        planes[0] = {y ? y + 1 : nullptr, 2, yStride};
+        planes[1] = {y, 4, yStride};
+        planes[2] = {y ? y + 2 : nullptr, 4, yStride};
+        break;
+    case AV_PIX_FMT_YUYV422:
+        planes[0] = {y, 2, yStride};
+        planes[1] = {y ? y + 1 : nullptr, 4, yStride};
+        planes[2] = {y ? y + 3 : nullptr, 4, yStride};
+        break;
+    default:
+        planes[0] = {y, 1, yStride};
+        planes[1] = {uv, 1, uvStride};
+        planes[2] = {frame->vPtr(), 1, uvStride};
+        break;
+    }
+}
+
+// Rows are compared one at a time, the padding at the end of each row is skipped
+uint64_t planeSquaredDiff(const PlaneSamples& p1, const PlaneSamples& p2, size_t width, size_t height) {
+    uint64_t sum = 0;
+    for (size_t row = 0; row < height; ++row) {
+        const uint8_t* r1 = p1.data + row * p1.stride;
+        const uint8_t* r2 = p2.data + row * p2.stride;
+        if (p1.step == 1 && p2.step == 1) {
+            sum += sumSquaredDiff(r1, r2, width);
+        } else {
+            sum += sumSquaredDiffStrided(r1, p1.step, r2, p2.step, width);
+        }
+    }
+    return sum;
+}
+} // namespace
+
 PSNRResult CompareHelper::getPSNR(FrameData* frame1, FrameData* frame2, FrameMeta* metadata1, FrameMeta* metadata2) {
 
     int yW = metadata1->yWidth();
@@ -93,16 +170,16 @@ PSNRResult CompareHelper::getPSNR(FrameData* frame1, FrameData* frame2, FrameMet
     size_t yCount = static_cast<size_t>(yW) * static_cast<size_t>(yH);
     size_t uvCount = static_cast<size_t>(uvW) * static_cast<size_t>(uvH);
 
-    const uint8_t* y1 = frame1->yPtr();
-    const uint8_t* u1 = frame1->uPtr();
-    const uint8_t* v1 = frame1->vPtr();
-    const uint8_t* y2 = frame2->yPtr();
-    const uint8_t* u2 = frame2->uPtr();
-    const uint8_t* v2 = frame2->vPtr();
+    PlaneSamples planes1[3];
+    PlaneSamples planes2[3];
+    samplePlanes(frame1, metadata1, planes1);
+    samplePlanes(frame2, metadata2 ? metadata2 : metadata1, planes2);
 
-    if (!y1 || !u1 || !v1 || !y2 || !u2 || !v2) {
-        ErrorReporter::instance().report("CompareHelper::getPSNR - null plane pointer", LogLevel::Warning);
-        return {};
+    for (int i = 0; i < 3; ++i) {
+        if (!planes1[i].data || !planes2[i].data) {
+            ErrorReporter::instance().report("CompareHelper::getPSNR - null plane pointer", LogLevel::Warning);
+            return {};
+        }
     }
 
     // Determine bit depth from pixel format (assume 8 if descriptor unavailable)
@@ -110,9 +187,9 @@ PSNRResult CompareHelper::getPSNR(FrameData* frame1, FrameData* frame2, FrameMet
 
     double maxSampleValue = static_cast<double>((1ULL << bitDepth) - 1ULL);
 
-    uint64_t ySSD = sumSquaredDiff(y1, y2, yCount);
-    uint64_t uSSD = sumSquaredDiff(u1, u2, uvCount);
-    uint64_t vSSD = sumSquaredDiff(v1, v2, uvCount);
+    uint64_t ySSD = planeSquaredDiff(planes1[0], planes2[0], yW, yH);
+    uint64_t uSSD = planeSquaredDiff(planes1[1], planes2[1], uvW, uvH);
+    uint64_t vSSD = planeSquaredDiff(planes1[2], planes2[2], uvW, uvH);
 
     if (ySSD == 0 && uSSD == 0 && vSSD == 0) {
         return PSNRResult(std::numeric_limits<double>::infinity(),
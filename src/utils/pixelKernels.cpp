@@ -0,0 +1,216 @@
+#include "pixelKernels.h"
+#include <initializer_list>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define YUVIZ_KERNELS_X86
+#include <immintrin.h>
+#define KERNEL_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define YUVIZ_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// Scalar reference, also finishes the rows the vector kernels leave over
+
+// UYVY: U0 Y0 V0 Y1 (4 bytes for 2 pixels)
+void uyvyToPlanarScalar(const uint8_t* src, uint8_t* y, uint8_t* u, uint8_t* v, int width) {
+    for (int x = 0; x < width; x += 2) {
+        const uint8_t* px = src + x * 2;
+        y[x] = px[1];
+        if (x + 1 < width) {
+            y[x + 1] = px[3];
+        }
+        u[x / 2] = px[0];
+        v[x / 2] = px[2];
+    }
+}
+
+// YUYV: Y0 U0 Y1 V0 (4 bytes for 2 pixels)
+void yuyvToPlanarScalar(const uint8_t* src, uint8_t* y, uint8_t* u, uint8_t* v, int width) {
+    for (int x = 0; x < width; x += 2) {
+        const uint8_t* px = src + x * 2;
+        y[x] = px[0];
+        if (x + 1 < width) {
+            y[x + 1] = px[2];
+        }
+        u[x / 2] = px[1];
+        v[x / 2] = px[3];
+    }
+}
+
+const PixelKernels::Kernels kScalar = {PixelKernels::Isa::Scalar, uyvyToPlanarScalar, yuyvToPlanarScalar};
+
+#ifdef YUVIZ_KERNELS_X86
+
+// SSE2: even and odd bytes are separated by masking or shifting 16-bit lanes, then packing them
+
+template <bool LumaOdd>
+KERNEL_TARGET("sse2")
+void packedToPlanarSse2(const uint8_t* src, uint8_t* y, uint8_t* u, uint8_t* v, int width) {
+    const __m128i mask = _mm_set1_epi16(0x00ff);
+    const __m128i zero = _mm_setzero_si128();
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 2));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 2 + 16));
+        __m128i even = _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask));
+        __m128i odd = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+        __m128i luma = LumaOdd ? odd : even;
+        __m128i chroma = LumaOdd ? even : odd;
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(y + x), luma);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(u + x / 2), _mm_packus_epi16(_mm_and_si128(chroma, mask), zero));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(v + x / 2), _mm_packus_epi16(_mm_srli_epi16(chroma, 8), zero));
+    }
+    if (LumaOdd) {
+        uyvyToPlanarScalar(src + x * 2, y + x, u + x / 2, v + x / 2, width - x);
+    } else {
+        yuyvToPlanarScalar(src + x * 2, y + x, u + x / 2, v + x / 2, width - x);
+    }
+}
+
+const PixelKernels::Kernels kSse2 = {PixelKernels::Isa::SSE2, packedToPlanarSse2<true>, packedToPlanarSse2<false>};
+
+// SSSE3: one byte shuffle per 16 bytes gathers each component into its own lane group
+
+template <bool LumaOdd>
+KERNEL_TARGET("ssse3")
+void packedToPlanarSsse3(const uint8_t* src, uint8_t* y, uint8_t* u, uint8_t* v, int width) {
+    // 8 pixels become Y0..Y7 U0..U3 V0..V3
+    const __m128i shuffle = LumaOdd ? _mm_setr_epi8(1, 3, 5, 7, 9, 11, 13, 15, 0, 4, 8, 12, 2, 6, 10, 14)
+                                    : _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 5, 9, 13, 3, 7, 11, 15);
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i a = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 2)), shuffle);
+        __m128i b = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 2 + 16)), shuffle);
+        // U0..U3 U4..U7 V0..V3 V4..V7
+        __m128i chroma = _mm_unpackhi_epi32(a, b);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(y + x), _mm_unpacklo_epi64(a, b));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(u + x / 2), chroma);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(v + x / 2), _mm_srli_si128(chroma, 8));
+    }
+    if (LumaOdd) {
+        uyvyToPlanarScalar(src + x * 2, y + x, u + x / 2, v + x / 2, width - x);
+    } else {
+        yuyvToPlanarScalar(src + x * 2, y + x, u + x / 2, v + x / 2, width - x);
+    }
+}
+
+const PixelKernels::Kernels kSsse3 = {PixelKernels::Isa::SSSE3, packedToPlanarSsse3<true>, packedToPlanarSsse3<false>};
+
+// AVX2: same scheme as SSE2 on 32 byte registers, packs work per 128-bit lane so the 64-bit
+// quarters are put back in order afterwards
+
+template <bool LumaOdd>
+KERNEL_TARGET("avx2")
+void packedToPlanarAvx2(const uint8_t* src, uint8_t* y, uint8_t* u, uint8_t* v, int width) {
+    const __m256i mask = _mm256_set1_epi16(0x00ff);
+    int x = 0;
+    for (; x + 32 <= width; x += 32) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x * 2));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x * 2 + 32));
+        __m256i even = _mm256_packus_epi16(_mm256_and_si256(a, mask), _mm256_and_si256(b, mask));
+        __m256i odd = _mm256_packus_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+        __m256i luma = _mm256_permute4x64_epi64(LumaOdd ? odd : even, 0xd8);
+        __m256i chroma = _mm256_permute4x64_epi64(LumaOdd ? even : odd, 0xd8);
+        // U0..U7 V0..V7 | U8..U15 V8..V15, reordered to U0..U15 V0..V15
+        __m256i planes = _mm256_packus_epi16(_mm256_and_si256(chroma, mask), _mm256_srli_epi16(chroma, 8));
+        planes = _mm256_permute4x64_epi64(planes, 0xd8);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(y + x), luma);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(u + x / 2), _mm256_castsi256_si128(planes));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(v + x / 2), _mm256_extracti128_si256(planes, 1));
+    }
+    packedToPlanarSsse3<LumaOdd>(src + x * 2, y + x, u + x / 2, v + x / 2, width - x);
+}
+
+const PixelKernels::Kernels kAvx2 = {PixelKernels::Isa::AVX2, packedToPlanarAvx2<true>, packedToPlanarAvx2<false>};
+
+#endif // YUVIZ_KERNELS_X86
+
+#ifdef YUVIZ_KERNELS_NEON
+
+// NEON: structured loads deinterleave the 4 byte pixel pairs directly
+
+template <bool LumaOdd>
+void packedToPlanarNeon(const uint8_t* src, uint8_t* y, uint8_t* u, uint8_t* v, int width) {
+    int x = 0;
+    for (; x + 32 <= width; x += 32) {
+        // UYVY: U Y0 V Y1, YUYV: Y0 U Y1 V
+        uint8x16x4_t px = vld4q_u8(src + x * 2);
+        uint8x16x2_t luma;
+        luma.val[0] = LumaOdd ? px.val[1] : px.val[0];
+        luma.val[1] = LumaOdd ? px.val[3] : px.val[2];
+        vst2q_u8(y + x, luma);
+        vst1q_u8(u + x / 2, LumaOdd ? px.val[0] : px.val[1]);
+        vst1q_u8(v + x / 2, LumaOdd ? px.val[2] : px.val[3]);
+    }
+    if (LumaOdd) {
+        uyvyToPlanarScalar(src + x * 2, y + x, u + x / 2, v + x / 2, width - x);
+    } else {
+        yuyvToPlanarScalar(src + x * 2, y + x, u + x / 2, v + x / 2, width - x);
+    }
+}
+
+const PixelKernels::Kernels kNeon = {PixelKernels::Isa::NEON, packedToPlanarNeon<true>, packedToPlanarNeon<false>};
+
+#endif // YUVIZ_KERNELS_NEON
+
+} // namespace
+
+const PixelKernels::Kernels* PixelKernels::forIsa(Isa isa) {
+    switch (isa) {
+    case Isa::Scalar:
+        return &kScalar;
+#ifdef YUVIZ_KERNELS_X86
+    case Isa::SSE2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse2") ? &kSse2 : nullptr;
+    case Isa::SSSE3:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("ssse3") ? &kSsse3 : nullptr;
+    case Isa::AVX2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? &kAvx2 : nullptr;
+#endif
+#ifdef YUVIZ_KERNELS_NEON
+    case Isa::NEON:
+        return &kNeon;
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+const PixelKernels::Kernels& PixelKernels::best() {
+    static const Kernels& kernels = []() -> const Kernels& {
+        for (Isa isa : {Isa::AVX2, Isa::NEON, Isa::SSSE3, Isa::SSE2}) {
+            if (const Kernels* candidate = forIsa(isa)) {
+                return *candidate;
+            }
+        }
+        return kScalar;
+    }();
+    return kernels;
+}
+
+const char* PixelKernels::isaName(Isa isa) {
+    switch (isa) {
+    case Isa::Scalar:
+        return "scalar";
+    case Isa::SSE2:
+        return "SSE2";
+    case Isa::SSSE3:
+        return "SSSE3";
+    case Isa::AVX2:
+        return "AVX2";
+    case Isa::NEON:
+        return "NEON";
+    }
+    return "unknown";
+}
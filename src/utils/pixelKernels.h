@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Row kernels converting packed YUV into planar layouts
+ *
+ * Every kernel has a scalar reference implementation. Vector versions are compiled for the
+ * instruction sets the target architecture offers and picked at runtime from the CPU features.
+ */
+class PixelKernels {
+  public:
+    enum class Isa {
+        Scalar,
+        SSE2,
+        SSSE3,
+        AVX2,
+        NEON
+    };
+
+    // Converts one row of 4:2:2 packed pixels into Y, U and V rows
+    using PackedToPlanarRow = void (*)(const uint8_t* src, uint8_t* y, uint8_t* u, uint8_t* v, int width);
+
+    struct Kernels {
+        Isa isa;
+        PackedToPlanarRow uyvyToPlanar;
+        PackedToPlanarRow yuyvToPlanar;
+    };
+
+    /**
+     * @brief Fastest kernels supported by the running CPU, detected once
+     */
+    static const Kernels& best();
+
+    /**
+     * @brief Kernels of one instruction set
+     * @return nullptr when the set is not built in or not supported by the running CPU
+     */
+    static const Kernels* forIsa(Isa isa);
+
+    static const char* isaName(Isa isa);
+};
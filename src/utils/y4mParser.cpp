@@ -30,8 +30,13 @@ Y4MInfo Y4MParser::parseHeader(const QString& filePath) {
         return info;
     }
 
-    QString headerStr = QString::fromLatin1(headerData.left(headerEnd));
-    info.headerSize = headerEnd + 1; // Include newline character
+    return parseHeaderLine(headerData.left(headerEnd));
+}
+
+Y4MInfo Y4MParser::parseHeaderLine(const QByteArray& headerLine) {
+    Y4MInfo info;
+    QString headerStr = QString::fromLatin1(headerLine);
+    info.headerSize = headerLine.size() + 1; // Include newline character
 
     debug("y4m", QString("Y4M header content: %1").arg(headerStr));
 
@@ -184,35 +189,59 @@ double Y4MParser::parseFrameRate(const QString& frameRateStr) {
     return 25.0; // Default frame rate
 }
 
-int Y4MParser::calculateTotalFrames(const QString& filePath, const Y4MInfo& info) {
+std::vector<int64_t> Y4MParser::buildFrameIndex(const QString& filePath, const Y4MInfo& info) {
+    std::vector<int64_t> offsets;
     if (!info.isValid) {
-        return -1;
+        return offsets;
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        ErrorReporter::instance().report("Cannot open Y4M file: " + filePath.toStdString(), LogLevel::Error);
+        return offsets;
     }
 
-    QFileInfo fileInfo(filePath);
-    int64_t fileSize = fileInfo.size();
+    const int64_t fileSize = file.size();
+    const int64_t frameDataSize = calculateFrameSize(info);
+    if (frameDataSize <= 0) {
+        return offsets;
+    }
 
-    // Each frame contains "FRAME\n" prefix (6 bytes) plus frame data
-    int frameDataSize = calculateFrameSize(info);
-    int totalFrameSize = 6 + frameDataSize; // "FRAME\n" + actual frame data
+    // Frame parameters are optional and short, a frame line never gets near this limit
+    constexpr int kMaxFrameLine = 1024;
+    offsets.reserve(static_cast<size_t>((fileSize - info.headerSize) / (frameDataSize + 6)));
 
-    // File size - header size = total size of all frames
-    int64_t framesDataSize = fileSize - info.headerSize;
+    int64_t position = info.headerSize;
+    while (position < fileSize) {
+        if (!file.seek(position)) {
+            break;
+        }
 
-    if (framesDataSize <= 0 || totalFrameSize <= 0) {
-        return -1;
-    }
+        QByteArray line = file.read(kMaxFrameLine);
+        int lineEnd = line.indexOf('\n');
+        if (lineEnd < 5 || !line.startsWith("FRAME") || (lineEnd > 5 && line[5] != ' ')) {
+            warning("y4m", QString("Invalid Y4M frame marker at offset %1, stopping index").arg(position));
+            break;
+        }
 
-    int totalFrames = static_cast<int>(framesDataSize / totalFrameSize);
+        int64_t payload = position + lineEnd + 1;
+        if (payload + frameDataSize > fileSize) {
+            warning("y4m", QString("Truncated Y4M frame at offset %1 ignored").arg(position));
+            break;
+        }
+
+        offsets.push_back(payload);
+        position = payload + frameDataSize;
+    }
 
     debug("y4m",
-          QString("Y4M total frame calculation - File size: %1, Header size: %2, Frame size: %3, Total frames: %4")
+          QString("Y4M frame index built - File size: %1, Header size: %2, Frame size: %3, Total frames: %4")
               .arg(fileSize)
               .arg(info.headerSize)
-              .arg(totalFrameSize)
-              .arg(totalFrames));
+              .arg(frameDataSize)
+              .arg(offsets.size()));
 
-    return totalFrames;
+    return offsets;
 }
 
 int Y4MParser::calculateFrameSize(const Y4MInfo& info) {
@@ -3,8 +3,10 @@
 #include <QFileInfo>
 #include <QString>
 #include <QTextStream>
+#include <cstdint>
 #include <fstream>
 #include <string>
+#include <vector>
 
 extern "C" {
 #include <libavutil/pixfmt.h>
@@ -32,7 +34,7 @@ struct Y4MInfo {
  *
  * Y4M format description:
  * - File header: YUV4MPEG2 W<width> H<height> F<framerate> I<interlacing> A<aspect> C<colorspace>
- * - Frame prefix: FRAME
+ * - Frame prefix: FRAME [parameters]
  */
 class Y4MParser {
   public:
@@ -43,6 +45,13 @@ class Y4MParser {
      */
     static Y4MInfo parseHeader(const QString& filePath);
 
+    /**
+     * @brief Parse a Y4M header line already read from a file or stream
+     * @param headerLine Header line without the trailing newline
+     * @return Y4M format information structure
+     */
+    static Y4MInfo parseHeaderLine(const QByteArray& headerLine);
+
     /**
      * @brief Check if file is Y4M format
      * @param filePath File path
@@ -65,12 +74,16 @@ class Y4MParser {
     static double parseFrameRate(const QString& frameRateStr);
 
     /**
-     * @brief Calculate total frames in Y4M file
+     * @brief Scan the frame markers of a Y4M file once
+     *
+     * FRAME lines may carry parameters, so their length is not fixed. Truncated trailing frames
+     * are left out.
+     *
      * @param filePath File path
      * @param info Y4M format information
-     * @return Total frame count
+     * @return File offset of each frame's payload, one entry per frame
      */
-    static int calculateTotalFrames(const QString& filePath, const Y4MInfo& info);
+    static std::vector<int64_t> buildFrameIndex(const QString& filePath, const Y4MInfo& info);
 
     /**
      * @brief Calculate frame data size (excluding FRAME prefix)
@@ -57,9 +57,9 @@ void FrameControllerTest::testFCStart() {
     int fakePts = 0;
 
     EXPECT_CALL(*decoder, loadFrame(_)).WillRepeatedly([&](FrameData* frame) {
-        memset(frame->yPtr(), 128, meta.ySize());
-        memset(frame->uPtr(), 128, meta.uvSize());
-        memset(frame->vPtr(), 128, meta.uvSize());
+        memset(frame->yPtr(), 128, meta.yPlaneSize());
+        memset(frame->uPtr(), 128, meta.uvPlaneSize());
+        memset(frame->vPtr(), 128, meta.uvPlaneSize());
         frame->setPts(fakePts++);
         emit decoder->frameLoaded(true);
     });
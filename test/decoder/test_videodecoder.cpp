@@ -0,0 +1,160 @@
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QtTest>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include "decoder/videoDecoder.h"
+#include "frames/frameMeta.h"
+#include "frames/frameQueue.h"
+
+namespace {
+constexpr int kWidth = 64;
+constexpr int kHeight = 64;
+constexpr int kFrames = 40;
+constexpr int kGopSize = 10;
+
+// The first frame is presented at frame 12 of the stream, frame indices still count from it
+constexpr int64_t kStartFrame = 12;
+
+// Luma of every pixel of frame i, far enough apart that a neighbouring frame never passes for it
+int level(int64_t frame) {
+    return 16 + 5 * static_cast<int>(frame);
+}
+constexpr int kTolerance = 2;
+
+// Flat gray MPEG-4 frames in Matroska, whose millisecond time base needs the frame rate conversion
+bool writeClip(const QString& path) {
+    const AVCodec* codec = avcodec_find_encoder(AV_CODEC_ID_MPEG4);
+    AVFormatContext* format = nullptr;
+    if (!codec || avformat_alloc_output_context2(&format, nullptr, "matroska", path.toUtf8().constData()) < 0) {
+        return false;
+    }
+
+    AVCodecContext* encoder = avcodec_alloc_context3(codec);
+    AVStream* stream = avformat_new_stream(format, nullptr);
+    AVFrame* frame = av_frame_alloc();
+    AVPacket* packet = av_packet_alloc();
+    bool ok = encoder && stream && frame && packet;
+
+    if (ok) {
+        encoder->width = kWidth;
+        encoder->height = kHeight;
+        encoder->pix_fmt = AV_PIX_FMT_YUV420P;
+        encoder->time_base = {1, 25};
+        encoder->framerate = {25, 1};
+        encoder->gop_size = kGopSize;
+        encoder->max_b_frames = 0;
+        encoder->flags |= AV_CODEC_FLAG_QSCALE;
+        encoder->global_quality = FF_QP2LAMBDA * 2;
+        if (format->oformat->flags & AVFMT_GLOBALHEADER) {
+            encoder->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+        }
+        stream->time_base = encoder->time_base;
+
+        frame->format = encoder->pix_fmt;
+        frame->width = kWidth;
+        frame->height = kHeight;
+        ok = avcodec_open2(encoder, codec, nullptr) >= 0 &&
+             avcodec_parameters_from_context(stream->codecpar, encoder) >= 0 &&
+             avio_open(&format->pb, path.toUtf8().constData(), AVIO_FLAG_WRITE) >= 0 &&
+             avformat_write_header(format, nullptr) >= 0 && av_frame_get_buffer(frame, 0) >= 0;
+    }
+
+    auto writePackets = [&]() {
+        while (ok && avcodec_receive_packet(encoder, packet) >= 0) {
+            av_packet_rescale_ts(packet, encoder->time_base, stream->time_base);
+            packet->stream_index = stream->index;
+            ok = av_interleaved_write_frame(format, packet) >= 0;
+        }
+    };
+
+    for (int i = 0; ok && i < kFrames; ++i) {
+        ok = av_frame_make_writable(frame) >= 0;
+        for (int y = 0; ok && y < kHeight; ++y) {
+            memset(frame->data[0] + y * frame->linesize[0], level(i), kWidth);
+        }
+        for (int y = 0; ok && y < kHeight / 2; ++y) {
+            memset(frame->data[1] + y * frame->linesize[1], 128, kWidth / 2);
+            memset(frame->data[2] + y * frame->linesize[2], 128, kWidth / 2);
+        }
+        frame->pts = kStartFrame + i;
+        frame->quality = encoder->global_quality;
+        ok = ok && avcodec_send_frame(encoder, frame) >= 0;
+        writePackets();
+    }
+    ok = ok && avcodec_send_frame(encoder, nullptr) >= 0;
+    writePackets();
+    ok = ok && av_write_trailer(format) >= 0;
+
+    av_packet_free(&packet);
+    av_frame_free(&frame);
+    avcodec_free_context(&encoder);
+    if (format->pb) {
+        avio_closep(&format->pb);
+    }
+    avformat_free_context(format);
+    return ok;
+}
+} // namespace
+
+class VideoDecoderTest : public QObject {
+    Q_OBJECT
+
+  private:
+    std::unique_ptr<VideoDecoder> openDecoder(const VideoDecoder* primary = nullptr);
+
+    QTemporaryDir m_dir;
+    QString m_clip;
+
+  private slots:
+    void initTestCase();
+    void testSegmentSeekPts();
+};
+
+// Like the decoders of a FrameController, a segment decoder opens the file with the primary's probe
+std::unique_ptr<VideoDecoder> VideoDecoderTest::openDecoder(const VideoDecoder* primary) {
+    auto decoder = std::make_unique<VideoDecoder>();
+    decoder->setFileName(m_clip.toStdString());
+    decoder->setForceSoftwareDecoding(true);
+    decoder->shareProbe(primary);
+    decoder->openFile();
+    return decoder;
+}
+
+void VideoDecoderTest::initTestCase() {
+    // Keeps the metadata cache entries of the clip out of the user's cache
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(m_dir.isValid());
+    m_clip = m_dir.filePath("clip.mkv");
+    QVERIFY(writeClip(m_clip));
+}
+
+// A segment decoder starts with a seek, the first frame it decodes is a keyframe in the middle of the stream
+void VideoDecoderTest::testSegmentSeekPts() {
+    std::unique_ptr<VideoDecoder> primary = openDecoder();
+    std::unique_ptr<VideoDecoder> segment = openDecoder(primary.get());
+    FrameMeta meta = primary->getMetaData();
+    QCOMPARE(meta.yWidth(), kWidth);
+    QCOMPARE(segment->getMetaData().totalFrames(), meta.totalFrames());
+
+    auto queue = std::make_shared<FrameQueue>(std::make_shared<FrameMeta>(meta), 16);
+    primary->setFrameQueue(queue);
+    segment->setFrameQueue(queue);
+    segment->setPublishTail(false);
+
+    // Past a keyframe, the frames before the target are decoded and dropped
+    const int64_t target = 33;
+    const int count = 2;
+    segment->seek(target, count);
+    for (int64_t pts = target; pts < target + count; ++pts) {
+        FrameData* frame = queue->getHeadFrame(pts);
+        QVERIFY2(frame, qPrintable(QString("Frame %1 not published").arg(pts)));
+        QVERIFY(std::abs(frame->yPtr()[0] - level(pts)) <= kTolerance);
+    }
+    // Only decoded to reach the target
+    QVERIFY(!queue->getHeadFrame(target - target % kGopSize));
+}
+
+QTEST_MAIN(VideoDecoderTest)
+#include "test_videodecoder.moc"
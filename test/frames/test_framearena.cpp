@@ -0,0 +1,116 @@
+#include <QtTest>
+#include <memory>
+#include "frames/frameArena.h"
+#include "frames/frameMeta.h"
+#include "frames/frameQueue.h"
+#include "utils/appConfig.h"
+
+namespace {
+// 64x64 YUV420P frames take 6 KB, one page aligned slot of 8 KB each
+constexpr int64_t kSlotBytes = 8192;
+constexpr int kQueueSlots = 16;
+
+// Room for one queue and half of a second one, counting the alignment slack of the two slabs
+constexpr int64_t kBudget = (kQueueSlots + kQueueSlots / 2) * kSlotBytes + 2 * 4096;
+} // namespace
+
+class FrameArenaTest : public QObject {
+    Q_OBJECT
+
+  private:
+    std::shared_ptr<FrameMeta> makeMeta();
+
+  private slots:
+    void init();
+    void cleanup();
+    void testFairShare();
+    void testReclaimFromIdleQueue();
+    void testChargeTrimsSpareSlabs();
+};
+
+std::shared_ptr<FrameMeta> FrameArenaTest::makeMeta() {
+    auto meta = std::make_shared<FrameMeta>();
+    meta->setYWidth(64);
+    meta->setYHeight(64);
+    meta->setUVWidth(32);
+    meta->setUVHeight(32);
+    meta->setPixelFormat(AV_PIX_FMT_YUV420P);
+    meta->setTotalFrames(1 << 20);
+    return meta;
+}
+
+void FrameArenaTest::init() {
+    AppConfig::instance().setCacheBudget(kBudget);
+}
+
+// Without a budget releasing the queues leaves no spare slabs behind for the next test
+void FrameArenaTest::cleanup() {
+    AppConfig::instance().setCacheBudget(0);
+    FrameArena::instance().release(kSlotBytes, {});
+    QCOMPARE(FrameArena::instance().stats().reservedBytes, int64_t(0));
+}
+
+void FrameArenaTest::testFairShare() {
+    FrameArena& arena = FrameArena::instance();
+    QCOMPARE(arena.fairShare(), kBudget);
+
+    FrameQueue first(makeMeta(), kQueueSlots);
+    QCOMPARE(arena.fairShare(), kBudget / 2);
+
+    FrameQueue second(makeMeta(), kQueueSlots / 2);
+    QCOMPARE(arena.fairShare(), kBudget / 3);
+    QCOMPARE(arena.stats().queues, 2);
+}
+
+void FrameArenaTest::testReclaimFromIdleQueue() {
+    FrameArena& arena = FrameArena::instance();
+    uint64_t reclaimedBefore = arena.stats().reclaimedSlots;
+
+    FrameQueue idle(makeMeta(), kQueueSlots);
+    QCOMPARE(idle.getSize(), kQueueSlots);
+    QCOMPARE(arena.stats().reclaimedSlots, reclaimedBefore);
+
+    // The second queue only fits when the idle one gives back the slots it never wrote
+    FrameQueue playing(makeMeta(), kQueueSlots);
+    QCOMPARE(playing.getSize(), kQueueSlots);
+    QCOMPARE(idle.getSize(), kQueueSlots / 2);
+
+    FrameArena::Stats stats = arena.stats();
+    QCOMPARE(stats.reclaimedSlots - reclaimedBefore, uint64_t(kQueueSlots / 2));
+    QCOMPARE(stats.usedBytes, (kQueueSlots + kQueueSlots / 2) * kSlotBytes);
+    QVERIFY(stats.reservedBytes <= kBudget);
+    QCOMPARE(stats.sizeClasses, 1);
+
+    // Queues never shrink below the minimum a playback window needs
+    FrameQueue third(makeMeta(), kQueueSlots);
+    QCOMPARE(idle.getSize(), kQueueSlots / 2);
+    QCOMPARE(playing.getSize(), kQueueSlots / 2);
+    QVERIFY(arena.stats().reservedBytes > kBudget);
+}
+
+void FrameArenaTest::testChargeTrimsSpareSlabs() {
+    FrameArena& arena = FrameArena::instance();
+    auto owner = std::make_unique<FrameQueue>(makeMeta(), kQueueSlots);
+    int64_t reserved = arena.stats().reservedBytes;
+
+    // Within the budget the released slots stay around for the next queue of the same geometry
+    owner.reset();
+    QCOMPARE(arena.stats().reservedBytes, reserved);
+    QCOMPARE(arena.stats().usedBytes, int64_t(0));
+
+    arena.charge(kBudget);
+    FrameArena::Stats stats = arena.stats();
+    QCOMPARE(stats.chargedBytes, kBudget);
+    QCOMPARE(stats.reservedBytes, int64_t(0));
+
+    // Charged memory counts against the budget, a new queue has to allocate its slots again
+    FrameQueue queue(makeMeta(), kQueueSlots);
+    QCOMPARE(arena.stats().reservedBytes, reserved);
+
+    arena.uncharge(kBudget);
+    QCOMPARE(arena.stats().chargedBytes, int64_t(0));
+    QCOMPARE(arena.stats().usedBytes, kQueueSlots * kSlotBytes);
+}
+
+QTEST_MAIN(FrameArenaTest)
+#include "test_framearena.moc"
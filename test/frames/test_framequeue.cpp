@@ -1,59 +1,225 @@
 #include <QtTest>
+#include <atomic>
+#include <cstring>
 #include <set>
+#include <thread>
+#include <vector>
 #include "frames/frameMeta.h"
 #include "frames/frameQueue.h"
 
 class FrameQueueTest : public QObject {
     Q_OBJECT
 
+  private:
+    std::shared_ptr<FrameMeta> makeMeta(int width, int height);
+    void writeFrame(FrameQueue& queue, int64_t pts);
+
   private slots:
     void testFifoOrder();
     void testReusability();
+    void testPinnedSlotSurvives();
+    void testClaimedSlotSurvives();
+    void testReleasedSlotReclaimed();
+    void testLeastRecentlyUsedEvictedFirst();
+    void testKeptRangeSurvives();
+    void testConcurrentHandoff();
 };
 
+std::shared_ptr<FrameMeta> FrameQueueTest::makeMeta(int width, int height) {
+    auto meta = std::make_shared<FrameMeta>();
+    meta->setYWidth(width);
+    meta->setYHeight(height);
+    meta->setUVWidth(width / 2);
+    meta->setUVHeight(height / 2);
+    meta->setPixelFormat(AV_PIX_FMT_YUV420P);
+    meta->setTotalFrames(1 << 20);
+    return meta;
+}
+
+// Fills every plane with the low byte of pts, so a torn frame shows up as mixed bytes
+void FrameQueueTest::writeFrame(FrameQueue& queue, int64_t pts) {
+    FrameMeta* meta = queue.metaPtr().get();
+    FrameData* frame = queue.getTailFrame(pts);
+    memset(frame->yPtr(), int(pts & 0xff), meta->yPlaneSize());
+    memset(frame->uPtr(), int(pts & 0xff), meta->uvPlaneSize());
+    memset(frame->vPtr(), int(pts & 0xff), meta->uvPlaneSize());
+    frame->setEndFrame(false);
+    frame->setPts(pts);
+    queue.updateTail(pts);
+}
+
 void FrameQueueTest::testFifoOrder() {
-    FrameMeta meta;
-    meta.setYWidth(2);
-    meta.setYHeight(2);
-    meta.setUVWidth(1);
-    meta.setUVHeight(1);
-    FrameQueue queue(meta);
+    FrameQueue queue(makeMeta(2, 2));
 
     // Write PTS values to 10 frames
     for (int i = 0; i < 10; ++i) {
-        auto* frame = queue.getTailFrame();
-        frame->setPts(i);
-        queue.incrementTail();
+        writeFrame(queue, i);
     }
 
     // Read back and check order
     for (int i = 0; i < 10; ++i) {
-        auto* frame = queue.getHeadFrame();
+        auto* frame = queue.getHeadFrame(i);
+        QVERIFY(frame);
         QCOMPARE(frame->pts(), int64_t(i));
-        queue.incrementHead();
     }
 }
 
 void FrameQueueTest::testReusability() {
-    FrameMeta meta;
-    meta.setYWidth(2);
-    meta.setYHeight(2);
-    meta.setUVWidth(1);
-    meta.setUVHeight(1);
-    FrameQueue queue(meta);
+    FrameQueue queue(makeMeta(2, 2));
 
     std::set<void*> framePtrs;
 
     for (int i = 0; i < 100; ++i) {
-        auto* f = queue.getTailFrame();
+        writeFrame(queue, i);
+        auto* f = queue.getHeadFrame(i);
+        QVERIFY(f);
         framePtrs.insert(static_cast<void*>(f));
-        queue.incrementTail();
-        queue.getHeadFrame();
-        queue.incrementHead();
     }
 
     // Should not exceed queueSize
-    QVERIFY(framePtrs.size() <= 50);
+    QVERIFY(framePtrs.size() <= size_t(queue.getSize()));
+}
+
+void FrameQueueTest::testPinnedSlotSurvives() {
+    FrameQueue queue(makeMeta(16, 16), 8);
+    writeFrame(queue, 0);
+
+    FrameData* frame = queue.getHeadFrame(0);
+    QVERIFY(frame);
+    FramePin pin(frame, 0);
+    QVERIFY(pin);
+
+    // Enough writes to cycle through every slot several times, the pinned one has to be skipped
+    for (int i = 1; i < 5 * queue.getSize(); ++i) {
+        writeFrame(queue, i);
+    }
+    QCOMPARE(frame->pts(), int64_t(0));
+    QCOMPARE(frame->yPtr()[0], uint8_t(0));
+
+    // A pin for a pts the slot does not hold fails
+    FramePin stale(queue.getHeadFrame(1), 0);
+    QVERIFY(!stale);
+}
+
+void FrameQueueTest::testClaimedSlotSurvives() {
+    FrameQueue queue(makeMeta(16, 16), 8);
+
+    // Like a frame a decoder thread is still decoding into its slot
+    FrameData* claimed = queue.getTailFrame(1000);
+    QVERIFY(claimed);
+
+    for (int i = 0; i < 5 * queue.getSize(); ++i) {
+        FrameData* frame = queue.getTailFrame(i);
+        QVERIFY(frame != claimed);
+        frame->setPts(i);
+    }
+    QVERIFY(!queue.getHeadFrame(1000));
+
+    // A second claim for the same pts gets a slot of its own
+    FrameData* again = queue.tryGetTailFrame(1000);
+    QVERIFY(again && again != claimed);
+    again->setPts(-1);
+    claimed->setPts(1000);
+    QCOMPARE(queue.getHeadFrame(1000), claimed);
+}
+
+void FrameQueueTest::testReleasedSlotReclaimed() {
+    FrameQueue queue(makeMeta(16, 16), 8);
+
+    std::vector<FrameData*> claimed;
+    for (int i = 0; i < queue.getSize(); ++i) {
+        claimed.push_back(queue.getTailFrame(i));
+        QVERIFY(claimed.back());
+    }
+    QVERIFY(!queue.tryGetTailFrame(100));
+
+    // Like a read that failed after claiming its slot
+    claimed[3]->setPts(-1);
+    QVERIFY(!queue.getHeadFrame(3));
+    QCOMPARE(queue.tryGetTailFrame(100), claimed[3]);
+}
+
+void FrameQueueTest::testLeastRecentlyUsedEvictedFirst() {
+    FrameQueue queue(makeMeta(16, 16), 16);
+
+    // The head far away from everything else, its window protects none of the other frames
+    writeFrame(queue, 100);
+    QVERIFY(queue.getHeadFrame(100));
+    for (int i = 0; i < 15; ++i) {
+        writeFrame(queue, i);
+    }
+
+    // Reading 0 makes 1 the least recently used frame, the latest half queue of writes is protected
+    QVERIFY(queue.getHeadFrame(0));
+    QVERIFY(queue.getHeadFrame(100));
+    writeFrame(queue, 300);
+    QVERIFY(!queue.getHeadFrame(1));
+    writeFrame(queue, 301);
+    QVERIFY(!queue.getHeadFrame(2));
+    QVERIFY(queue.getHeadFrame(0));
+}
+
+void FrameQueueTest::testKeptRangeSurvives() {
+    FrameQueue queue(makeMeta(16, 16), 16);
+
+    writeFrame(queue, 100);
+    QVERIFY(queue.getHeadFrame(100));
+    for (int i = 0; i < 15; ++i) {
+        writeFrame(queue, i);
+    }
+    QCOMPARE(queue.cachedRunEnd(0), int64_t(14));
+
+    // Two frames either side of 3 for a queue of 16
+    queue.keepAround(3);
+    for (int i = 200; i < 240; ++i) {
+        writeFrame(queue, i);
+    }
+
+    QCOMPARE(queue.cachedRunEnd(0), int64_t(-1));
+    QCOMPARE(queue.cachedRunEnd(1), int64_t(5));
+    QCOMPARE(queue.cachedRunEnd(6), int64_t(5));
+    // The head is never evicted either
+    QVERIFY(queue.getHeadFrame(100));
+}
+
+void FrameQueueTest::testConcurrentHandoff() {
+    auto meta = makeMeta(64, 32);
+    FrameQueue queue(meta, 8);
+    const int frames = 5000;
+    std::atomic<int64_t> written = -1;
+    std::atomic<bool> done = false;
+
+    // The decoder side also decodes frames it already holds again, like a seek back does
+    std::thread writer([&] {
+        for (int64_t i = 0; i < frames; ++i) {
+            int64_t pts = i % 3 == 2 ? i - 2 : i;
+            writeFrame(queue, pts);
+            written.store(pts);
+        }
+        done = true;
+    });
+
+    int torn = 0;
+    int reads = 0;
+    while (!done) {
+        int64_t pts = written.load() - reads % 5;
+        FrameData* frame = queue.getHeadFrame(pts);
+        FramePin pin(frame, pts);
+        if (!pin) {
+            continue;
+        }
+        const uint8_t* y = frame->yPtr();
+        for (int i = 0; i < meta->yPlaneSize(); ++i) {
+            if (y[i] != uint8_t(pts & 0xff)) {
+                ++torn;
+                break;
+            }
+        }
+        ++reads;
+    }
+    writer.join();
+
+    QCOMPARE(torn, 0);
 }
 
 QTEST_MAIN(FrameQueueTest)
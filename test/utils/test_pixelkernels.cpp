@@ -0,0 +1,115 @@
+#include <QtTest>
+#include <random>
+#include <vector>
+#include "utils/pixelKernels.h"
+
+Q_DECLARE_METATYPE(PixelKernels::Isa)
+
+class PixelKernelsTest : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void testUyvyToPlanar_data();
+    void testUyvyToPlanar();
+    void testYuyvToPlanar_data();
+    void testYuyvToPlanar();
+
+    void benchmarkUyvy4K_data();
+    void benchmarkUyvy4K();
+
+  private:
+    void addIsaColumns();
+    void comparePacked(bool uyvy);
+};
+
+namespace {
+std::vector<uint8_t> randomBytes(size_t size) {
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> dist(0, 255);
+    std::vector<uint8_t> bytes(size);
+    for (uint8_t& byte : bytes) {
+        byte = static_cast<uint8_t>(dist(rng));
+    }
+    return bytes;
+}
+
+// Odd sizes and sizes around every vector width exercise the scalar tails
+const int kWidths[] = {1, 2, 3, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 720, 1921, 3840};
+} // namespace
+
+void PixelKernelsTest::addIsaColumns() {
+    QTest::addColumn<PixelKernels::Isa>("isa");
+    for (PixelKernels::Isa isa :
+         {PixelKernels::Isa::SSE2, PixelKernels::Isa::SSSE3, PixelKernels::Isa::AVX2, PixelKernels::Isa::NEON}) {
+        if (PixelKernels::forIsa(isa)) {
+            QTest::newRow(PixelKernels::isaName(isa)) << isa;
+        }
+    }
+}
+
+void PixelKernelsTest::comparePacked(bool uyvy) {
+    QFETCH(PixelKernels::Isa, isa);
+    const PixelKernels::Kernels* kernels = PixelKernels::forIsa(isa);
+    const PixelKernels::Kernels* reference = PixelKernels::forIsa(PixelKernels::Isa::Scalar);
+    PixelKernels::PackedToPlanarRow convert = uyvy ? kernels->uyvyToPlanar : kernels->yuyvToPlanar;
+    PixelKernels::PackedToPlanarRow convertReference = uyvy ? reference->uyvyToPlanar : reference->yuyvToPlanar;
+
+    for (int width : kWidths) {
+        int uvWidth = (width + 1) / 2;
+        std::vector<uint8_t> src = randomBytes(uvWidth * 4);
+        std::vector<uint8_t> expectedY(width), expectedU(uvWidth), expectedV(uvWidth);
+        std::vector<uint8_t> actualY(width), actualU(uvWidth), actualV(uvWidth);
+
+        convertReference(src.data(), expectedY.data(), expectedU.data(), expectedV.data(), width);
+        convert(src.data(), actualY.data(), actualU.data(), actualV.data(), width);
+
+        QVERIFY2(actualY == expectedY, qPrintable(QString("Y differs at width %1").arg(width)));
+        QVERIFY2(actualU == expectedU, qPrintable(QString("U differs at width %1").arg(width)));
+        QVERIFY2(actualV == expectedV, qPrintable(QString("V differs at width %1").arg(width)));
+    }
+}
+
+void PixelKernelsTest::testUyvyToPlanar_data() {
+    addIsaColumns();
+}
+
+void PixelKernelsTest::testUyvyToPlanar() {
+    comparePacked(true);
+}
+
+void PixelKernelsTest::testYuyvToPlanar_data() {
+    addIsaColumns();
+}
+
+void PixelKernelsTest::testYuyvToPlanar() {
+    comparePacked(false);
+}
+
+void PixelKernelsTest::benchmarkUyvy4K_data() {
+    addIsaColumns();
+    QTest::newRow("scalar") << PixelKernels::Isa::Scalar;
+}
+
+void PixelKernelsTest::benchmarkUyvy4K() {
+    QFETCH(PixelKernels::Isa, isa);
+    const PixelKernels::Kernels* kernels = PixelKernels::forIsa(isa);
+
+    const int width = 3840;
+    const int height = 2160;
+    std::vector<uint8_t> src = randomBytes(static_cast<size_t>(width) * height * 2);
+    std::vector<uint8_t> y(static_cast<size_t>(width) * height);
+    std::vector<uint8_t> u(y.size() / 2), v(y.size() / 2);
+
+    QBENCHMARK {
+        for (int row = 0; row < height; row++) {
+            kernels->uyvyToPlanar(src.data() + row * width * 2,
+                                  y.data() + row * width,
+                                  u.data() + row * width / 2,
+                                  v.data() + row * width / 2,
+                                  width);
+        }
+    }
+}
+
+QTEST_MAIN(PixelKernelsTest)
+#include "test_pixelkernels.moc"
@@ -0,0 +1,130 @@
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtTest>
+#include <cstdint>
+#include <vector>
+#include "utils/y4mParser.h"
+
+class Y4MParserTest : public QObject {
+    Q_OBJECT
+
+  private:
+    QString writeFile(const QString& name, const QByteArray& contents);
+    void compareIndex(const std::vector<int64_t>& index, const std::vector<int64_t>& expected);
+
+    QTemporaryDir m_dir;
+
+  private slots:
+    void testHeaderLine();
+    void testFrameParameters();
+    void testInvalidFrameMarker();
+    void testOffsetsPastInt32();
+};
+
+QString Y4MParserTest::writeFile(const QString& name, const QByteArray& contents) {
+    QString path = m_dir.filePath(name);
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(contents) != contents.size()) {
+        return QString();
+    }
+    return path;
+}
+
+void Y4MParserTest::compareIndex(const std::vector<int64_t>& index, const std::vector<int64_t>& expected) {
+    QCOMPARE(index.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        QCOMPARE(index[i], expected[i]);
+    }
+}
+
+void Y4MParserTest::testHeaderLine() {
+    QByteArray header = "YUV4MPEG2 W6 H4 F30000:1001 Ip A1:1 C420jpeg";
+    Y4MInfo info = Y4MParser::parseHeaderLine(header);
+    QVERIFY(info.isValid);
+    QCOMPARE(info.width, 6);
+    QCOMPARE(info.height, 4);
+    QCOMPARE(info.interlacing, QString("p"));
+    QCOMPARE(info.pixelFormat, AV_PIX_FMT_YUV420P);
+    QCOMPARE(info.headerSize, int(header.size()) + 1);
+    QCOMPARE(Y4MParser::calculateFrameSize(info), 6 * 4 + 2 * 3 * 2);
+}
+
+void Y4MParserTest::testFrameParameters() {
+    QVERIFY(m_dir.isValid());
+    QByteArray contents = "YUV4MPEG2 W4 H2 F25:1 C444\n";
+    const int frameSize = 4 * 2 * 3;
+
+    // The first payload looks like frame lines itself, the scan has to step over it
+    const QByteArray lines[] = {"FRAME\n", "FRAME Ip\n", "FRAME Ib XA1:1 Xcustom=long-value\n", "FRAME It\n"};
+    const QByteArray payloads[] = {"FRAME\nFRAME\nFRAME\nFRAME\n", QByteArray(frameSize, 'b'),
+                                   QByteArray(frameSize, '\n'), QByteArray(frameSize, 'd')};
+    std::vector<int64_t> expected;
+    for (int i = 0; i < 4; ++i) {
+        QCOMPARE(int(payloads[i].size()), frameSize);
+        contents += lines[i];
+        expected.push_back(contents.size());
+        contents += payloads[i];
+    }
+    // A trailing frame cut short by a partial write is left out
+    contents += "FRAME Ip\n";
+    contents += QByteArray(frameSize / 2, 'e');
+
+    QString path = writeFile("parameters.y4m", contents);
+    QVERIFY(!path.isEmpty());
+    Y4MInfo info = Y4MParser::parseHeader(path);
+    QVERIFY(info.isValid);
+    QCOMPARE(info.pixelFormat, AV_PIX_FMT_YUV444P);
+    QCOMPARE(Y4MParser::calculateFrameSize(info), frameSize);
+
+    compareIndex(Y4MParser::buildFrameIndex(path, info), expected);
+}
+
+void Y4MParserTest::testInvalidFrameMarker() {
+    QVERIFY(m_dir.isValid());
+    QByteArray contents = "YUV4MPEG2 W2 H2 F25:1 Cmono\n";
+    contents += "FRAME Ip\n";
+    std::vector<int64_t> expected = {int64_t(contents.size())};
+    contents += QByteArray(4, 'a');
+
+    // Parameters have to be separated from the marker
+    contents += "FRAMEIp\n";
+    contents += QByteArray(4, 'b');
+
+    QString path = writeFile("invalid.y4m", contents);
+    QVERIFY(!path.isEmpty());
+    compareIndex(Y4MParser::buildFrameIndex(path, Y4MParser::parseHeader(path)), expected);
+}
+
+void Y4MParserTest::testOffsetsPastInt32() {
+    QVERIFY(m_dir.isValid());
+    QByteArray header = "YUV4MPEG2 W16384 H16384 F25:1 Cmono\n";
+    const int64_t frameSize = 16384LL * 16384;
+
+    // Sparse file, only the header and the frame lines take disk space
+    QFile file(m_dir.filePath("large.y4m"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(header), qint64(header.size()));
+
+    std::vector<int64_t> expected;
+    int64_t position = header.size();
+    for (int i = 0; i < 10; ++i) {
+        QByteArray line = i % 2 ? "FRAME Ip XA1:1\n" : "FRAME\n";
+        QVERIFY(file.seek(position));
+        QCOMPARE(file.write(line), qint64(line.size()));
+        expected.push_back(position + line.size());
+        position = expected.back() + frameSize;
+    }
+    if (!file.resize(position)) {
+        QSKIP("Cannot create a file past 2 GB here");
+    }
+    file.close();
+    QVERIFY(expected.back() > INT32_MAX);
+
+    Y4MInfo info = Y4MParser::parseHeader(file.fileName());
+    QVERIFY(info.isValid);
+    QCOMPARE(int64_t(Y4MParser::calculateFrameSize(info)), frameSize);
+    compareIndex(Y4MParser::buildFrameIndex(file.fileName(), info), expected);
+}
+
+QTEST_MAIN(Y4MParserTest)
+#include "test_y4mparser.moc"